@@ -21,6 +21,12 @@ public class EditorMiscUtilities : ModuleRules
                 "DeveloperSettings",
 				"UnrealEd",
 				"ToolMenus",
+				"ImageWrapper",
+				"ImageCore",
+				"RHI",
+				"RenderCore",
+				"AssetRegistry",
+				"Json",
 
 				"PropertyEditor"
 	        }
@@ -7,9 +7,12 @@
 
 #include <PropertyCustomizationHelpers.h>
 #include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
 
 #include "Components/ActorComponent.h"
 #include "EditorMiscUtilitiesSettings.h"
+#include "SComponentTagPicker.h"
+#include <ScopedTransaction.h>
 
 
 #define LOCTEXT_NAMESPACE "ComponentTagCustomization"
@@ -35,7 +38,7 @@ void FActorComponentTagsCustomization::CustomizeHeader(TSharedRef<IPropertyHandl
 		SNew(SHorizontalBox)
 		+ SHorizontalBox::Slot().AutoWidth().Padding(0, 0, 5, 0)
 		[
-			SNew(SComboButton)
+			SAssignNew(TagComboButton, SComboButton)
 			.ButtonStyle(FAppStyle::Get(), "SimpleButton")
 			.HasDownArrow(false)			
 			.ToolTipText(LOCTEXT("PickComponentTag", "Pick Component Tag"))
@@ -56,8 +59,6 @@ void FActorComponentTagsCustomization::CustomizeHeader(TSharedRef<IPropertyHandl
 
 void FActorComponentTagsCustomization::CustomizeChildren(TSharedRef<IPropertyHandle> PropertyHandle, IDetailChildrenBuilder& ChildBuilder, IPropertyTypeCustomizationUtils& CustomizationUtils)
 {
-	const bool bTagsEditable = true;
-
 	uint32 NumChildren = 0;
 	PropertyHandle->GetNumChildren(NumChildren);
 	for (uint32 Index = 0; Index < NumChildren; Index++)
@@ -66,72 +67,155 @@ void FActorComponentTagsCustomization::CustomizeChildren(TSharedRef<IPropertyHan
 	}
 }
 
-TSharedRef<SWidget> FActorComponentTagsCustomization::GetComponentTagOptions()
+TSharedRef<const FActorComponentTagsCustomization::FTagMenuData> FActorComponentTagsCustomization::GetTagMenuData(const UClass* ComponentClass)
 {
-	FMenuBuilder MenuBuilder(true, nullptr);
-	
-	const UClass* ComponentClass = TagsPropertyHandle->GetOuterBaseClass();
+	static TMap<TObjectKey<UClass>, TSharedRef<const FTagMenuData>> Cache;
+
+	const TSharedRef<const TArray<FActorComponentTagOptionInfo>> Options = GetDefault<UEditorMiscUtilities>()->GetActorComponentTagOptions(nullptr, ComponentClass);
+
+	// Settings hand out the same list until it is invalidated
+	if (const TSharedRef<const FTagMenuData>* Cached = Cache.Find(ComponentClass))
+	{
+		if ((*Cached)->Source == Options)
+		{
+			return *Cached;
+		}
+	}
 
-	const UEditorMiscUtilities* Settings = GetDefault<UEditorMiscUtilities>();
+	TSharedRef<const FTagMenuData> MenuData = BuildTagMenuData(Options);
+	Cache.Add(ComponentClass, MenuData);
+	return MenuData;
+}
 
-	TArray<FActorComponentTagOptionInfo> Options = Settings->GetCommonActorComponentTagOptions(nullptr, ComponentClass);
+TSharedRef<const FActorComponentTagsCustomization::FTagMenuData> FActorComponentTagsCustomization::BuildTagMenuData(const TSharedRef<const TArray<FActorComponentTagOptionInfo>>& Options)
+{
+	TSharedRef<FTagMenuData> MenuData = MakeShared<FTagMenuData>();
+	MenuData->Source = Options;
 
-	TMap<FString, TArray<FActorComponentTagOptionInfo>> Categories;
-	for (const FActorComponentTagOptionInfo& Option : Options)
+	// Options are sorted by category, so each category is a single run
+	TSet<FName> CategoryTags;
+	for (const FActorComponentTagOptionInfo& Option : *Options)
 	{
-		TArray<FActorComponentTagOptionInfo>& Arr = Categories.FindOrAdd(Option.Category);
+		if (MenuData->Categories.Num() == 0 || MenuData->Categories.Last().Name != Option.Category)
+		{
+			MenuData->Categories.AddDefaulted_GetRef().Name = Option.Category;
+			CategoryTags.Reset();
+		}
 
-		if (!Arr.ContainsByPredicate([&Option](const FActorComponentTagOptionInfo& Info) { return Info.Name == Option.Name; }))
+		bool bAlreadyInSet = false;
+		CategoryTags.Add(Option.Name, &bAlreadyInSet);
+		if (!bAlreadyInSet)
 		{
-			Arr.Add(Option);
-		}		
+			FTagCategory& Category = MenuData->Categories.Last();
+			Category.Options.Add(&Option);
+			Category.SearchStrings.Add((Option.Name.ToString() + TEXT(" ") + Option.Description).ToLower());
+		}
 	}
-	Categories.KeyStableSort([](const FString& A, const FString& B) { return A < B; });
-	
-	for (const auto& Pair : Categories)
+
+	MenuData->CategoryItems.Reserve(MenuData->Categories.Num());
+	for (int32 CategoryIndex = 0; CategoryIndex < MenuData->Categories.Num(); CategoryIndex++)
 	{
-		const FString CategoryName = Pair.Key;
-
-		MenuBuilder.BeginSection(*CategoryName, FText::FromString(CategoryName));
-
-		for (const FActorComponentTagOptionInfo& Option : Pair.Value)
-		{			
-			MenuBuilder.AddMenuEntry(
-				FText::FromName(Option.Name),
-				FText::FromString(Option.Description),
-				FSlateIcon(),
-				FUIAction(
-					FExecuteAction::CreateSP(this, &FActorComponentTagsCustomization::AddTag, Option.Name),
-					FCanExecuteAction(),
-					FIsActionChecked(),
-					FIsActionButtonVisible()
-				)
-			);
+		const FTagCategory& Category = MenuData->Categories[CategoryIndex];
+
+		TSharedRef<FTagMenuItem> CategoryItem = MakeShared<FTagMenuItem>();
+		CategoryItem->CategoryIndex = CategoryIndex;
+		CategoryItem->Children.Reserve(Category.Options.Num());
+		for (int32 OptionIndex = 0; OptionIndex < Category.Options.Num(); OptionIndex++)
+		{
+			TSharedRef<FTagMenuItem> OptionItem = MakeShared<FTagMenuItem>();
+			OptionItem->CategoryIndex = CategoryIndex;
+			OptionItem->Option = Category.Options[OptionIndex];
+			OptionItem->OptionIndex = OptionIndex;
+			CategoryItem->Children.Add(OptionItem);
 		}
-		MenuBuilder.EndSection();
+		MenuData->CategoryItems.Add(CategoryItem);
 	}
 
-	return MenuBuilder.MakeWidget();
+	EDITORMISCUTILITIES_COUNT(TagMenuEntries, Options->Num());
+
+	return MenuData;
 }
 
+TSharedRef<SWidget> FActorComponentTagsCustomization::GetComponentTagOptions()
+{
+	EDITORMISCUTILITIES_SCOPE(TagMenu);
+
+	const UClass* ComponentClass = TagsPropertyHandle->GetOuterBaseClass();
 
-void FActorComponentTagsCustomization::AddTag(FName Tag)
+	TSharedRef<SComponentTagPicker> Picker = SNew(SComponentTagPicker)
+		.MenuData(GetTagMenuData(ComponentClass))
+		.OnTagsPicked(this, &FActorComponentTagsCustomization::OnTagsPicked);
+
+	if (TagComboButton.IsValid())
+	{
+		TagComboButton->SetMenuContentWidgetToFocus(Picker->GetWidgetToFocusOnOpen());
+	}
+
+	return Picker;
+}
+
+void FActorComponentTagsCustomization::OnTagsPicked(const TArray<FName>& Tags)
 {
-	if (TagsPropertyHandle.IsValid())
+	if (TagComboButton.IsValid())
+	{
+		TagComboButton->SetIsOpen(false);
+	}
+	AddTags(Tags);
+}
+
+
+void FActorComponentTagsCustomization::AddTags(const TArray<FName>& Tags)
+{
+	if (!TagsPropertyHandle.IsValid() || Tags.Num() == 0)
+	{
+		return;
+	}
+
+	FArrayProperty* ArrayProperty = CastField<FArrayProperty>(TagsPropertyHandle->GetProperty());
+	if (ArrayProperty == nullptr)
+	{
+		return;
+	}
+
+	// Current tags of every edited component
+	TArray<void*> RawData;
+	TagsPropertyHandle->AccessRawData(RawData);
+
+	bool bAnyChanged = false;
+	TArray<FString> PerObjectValues;
+	PerObjectValues.Reserve(RawData.Num());
+	for (void* Data : RawData)
 	{
-		TSharedPtr<IPropertyHandleArray> AsArray = TagsPropertyHandle->AsArray();
-		if (AsArray->AddItem() == FPropertyAccess::Success)
+		TArray<FName> NewTags = Data ? *static_cast<const TArray<FName>*>(Data) : TArray<FName>();
+
+		TSet<FName> Existing(NewTags);
+		for (const FName& Tag : Tags)
 		{
-			uint32 NumElements;
-			if (AsArray->GetNumElements(NumElements) == FPropertyAccess::Success && NumElements > 0)
+			bool bAlreadyInSet = false;
+			Existing.Add(Tag, &bAlreadyInSet);
+			if (!bAlreadyInSet)
 			{
-				AsArray->GetElement(NumElements - 1)->SetValue(Tag);			
-				
-				if (Utils.IsValid())
-				{
-					Utils->ForceRefresh();
-				}				
-			}			
+				NewTags.Add(Tag);
+				bAnyChanged = true;
+			}
+		}
+
+		FString& Value = PerObjectValues.AddDefaulted_GetRef();
+		ArrayProperty->ExportTextItem_Direct(Value, &NewTags, nullptr, nullptr, PPF_None);
+	}
+
+	if (!bAnyChanged)
+	{
+		return;
+	}
+
+	// Single transaction and single write for all tags and all objects
+	FScopedTransaction Transaction(Tags.Num() == 1 ? LOCTEXT("AddComponentTag", "Add Component Tag") : LOCTEXT("AddComponentTags", "Add Component Tags"));
+	if (TagsPropertyHandle->SetPerObjectValues(PerObjectValues) == FPropertyAccess::Success)
+	{
+		if (Utils.IsValid())
+		{
+			Utils->ForceRefresh();
 		}
 	}
 }
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "IPropertyTypeCustomization.h"
 #include <PropertyEditorModule.h>
+#include "EditorMiscUtilitiesSettings.h"
 
 class IPropertyHandle;
 
@@ -22,27 +23,57 @@ public:
 	virtual void CustomizeChildren(TSharedRef<IPropertyHandle> PropertyHandle, IDetailChildrenBuilder& ChildBuilder, IPropertyTypeCustomizationUtils& CustomizationUtils) override;
 	//~ End IPropertyTypeCustomization Interface	
 
-	class FPropertyTypeIdentifier : public IPropertyTypeIdentifier
+	/** Tag options grouped by category, shared by all customization instances */
+	struct FTagCategory
 	{
-	public:
-		virtual bool IsPropertyTypeCustomized(const IPropertyHandle& PropertyHandle) const override
-		{
-			const FProperty* Property = PropertyHandle.GetProperty();
-			if (Property && Property->GetFName() == GET_MEMBER_NAME_CHECKED(UActorComponent, ComponentTags))
-			{
-				UClass* OwnerClass = Property->GetOwnerClass();
-				return OwnerClass && OwnerClass->IsChildOf(UActorComponent::StaticClass());
-			}
-			return false;
-		}
+		FString Name;
+		TArray<const FActorComponentTagOptionInfo*> Options;
+
+		/** Lowercase name and description of each option, for search */
+		TArray<FString> SearchStrings;
+	};
+
+	/** Tag picker tree item. Built once with the menu data, so opening the picker does not allocate per tag */
+	struct FTagMenuItem
+	{
+		int32 CategoryIndex = INDEX_NONE;
+
+		/** Null for category rows */
+		const FActorComponentTagOptionInfo* Option = nullptr;
+
+		/** Index in category, used to look up search string */
+		int32 OptionIndex = INDEX_NONE;
+
+		TArray<TSharedPtr<const FTagMenuItem>> Children;
+	};
+
+	struct FTagMenuData
+	{
+		/** Options that categories point into */
+		TSharedPtr<const TArray<FActorComponentTagOptionInfo>> Source;
+
+		TArray<FTagCategory> Categories;
+
+		/** Item per category with an item per option as children, in category order */
+		TArray<TSharedPtr<const FTagMenuItem>> CategoryItems;
 	};
 
+	static TSharedRef<const FTagMenuData> GetTagMenuData(const UClass* ComponentClass);
+
+	/** Group options into categories. Not cached. Not timed on its own, callers own the TagMenu stat scope */
+	static TSharedRef<const FTagMenuData> BuildTagMenuData(const TSharedRef<const TArray<FActorComponentTagOptionInfo>>& Options);
 
 private:
+
 	TSharedRef<SWidget> GetComponentTagOptions();
-	void AddTag(FName Tag);
+	void OnTagsPicked(const TArray<FName>& Tags);
+
+	/** Add tags missing on each edited object in one transaction */
+	void AddTags(const TArray<FName>& Tags);
+
+	TSharedPtr<class SComboButton> TagComboButton;
 
 	TSharedPtr<IPropertyHandle> TagsPropertyHandle;
 	TSharedPtr<IPropertyUtilities> Utils;
 
-};
\ No newline at end of file
+};
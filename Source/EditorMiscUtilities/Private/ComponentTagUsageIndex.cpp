@@ -0,0 +1,514 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "ComponentTagUsageIndex.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Async/Async.h>
+#include <Components/ActorComponent.h>
+#include <Engine/Blueprint.h>
+#include <Engine/Level.h>
+#include <Engine/SCS_Node.h>
+#include <Engine/SimpleConstructionScript.h>
+#include <Engine/World.h>
+#include <GameFramework/Actor.h>
+#include <HAL/FileManager.h>
+#include <Misc/PackageName.h>
+#include <Misc/Paths.h>
+#include <Serialization/NameAsStringProxyArchive.h>
+
+/** Bump when tag value or cache layout changes */
+static const int32 ComponentTagUsageCacheVersion = 1;
+
+const FName FComponentTagUsageIndex::AssetRegistryTagName = TEXT("EditorMiscUtilities.ComponentTags");
+
+
+FComponentTagUsageIndex& FComponentTagUsageIndex::Get()
+{
+	static FComponentTagUsageIndex Instance;
+	return Instance;
+}
+
+void FComponentTagUsageIndex::Initialize()
+{
+	if (bInitialized)
+	{
+		return;
+	}
+	bInitialized = true;
+
+	ExtraTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddRaw(this, &FComponentTagUsageIndex::OnGetExtraObjectTags);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FComponentTagUsageIndex::OnAssetChanged);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FComponentTagUsageIndex::OnAssetChanged);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FComponentTagUsageIndex::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FComponentTagUsageIndex::OnAssetRenamed);
+
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		bScanning = true;
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FComponentTagUsageIndex::StartScan);
+	}
+	else
+	{
+		StartScan();
+	}
+}
+
+void FComponentTagUsageIndex::Shutdown()
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+	bInitialized = false;
+
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraTagsHandle);
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+
+	if (bReady && bDirty)
+	{
+		SaveCache();
+	}
+
+	PackageUsages.Empty();
+	ClassTagCounts.Empty();
+	PendingChanges.Empty();
+	Version++;
+	bScanning = false;
+	bReady = false;
+	bDirty = false;
+}
+
+void FComponentTagUsageIndex::GetMostUsedTags(const UClass* ComponentClass, int32 MaxCount, TArray<TPair<FName, int32>>& OutTags) const
+{
+	OutTags.Reset();
+	if (!bReady || ComponentClass == nullptr || MaxCount <= 0)
+	{
+		return;
+	}
+
+	// Tags used on parent classes apply to children as well
+	TMap<FName, int32> Totals;
+	for (const UClass* Class = ComponentClass; Class; Class = Class->GetSuperClass())
+	{
+		if (const TMap<FName, int32>* Counts = ClassTagCounts.Find(Class->GetPathName()))
+		{
+			for (const TPair<FName, int32>& Pair : *Counts)
+			{
+				Totals.FindOrAdd(Pair.Key) += Pair.Value;
+			}
+		}
+
+		if (Class == UActorComponent::StaticClass())
+		{
+			break;
+		}
+	}
+
+	OutTags = Totals.Array();
+	OutTags.Sort([](const TPair<FName, int32>& A, const TPair<FName, int32>& B)
+	{
+		return A.Value != B.Value ? A.Value > B.Value : A.Key.LexicalLess(B.Key);
+	});
+	if (OutTags.Num() > MaxCount)
+	{
+		OutTags.SetNum(MaxCount);
+	}
+}
+
+FString FComponentTagUsageIndex::MakeTagValue(const UObject* Object)
+{
+	TMap<const UClass*, TMap<FName, int32>> Counts;
+
+	auto AddComponent = [&Counts](const UActorComponent* Component)
+	{
+		if (Component)
+		{
+			for (const FName& Tag : Component->ComponentTags)
+			{
+				if (!Tag.IsNone())
+				{
+					Counts.FindOrAdd(Component->GetClass()).FindOrAdd(Tag)++;
+				}
+			}
+		}
+	};
+
+	auto AddActor = [&AddComponent](const AActor* Actor)
+	{
+		if (Actor)
+		{
+			for (const UActorComponent* Component : Actor->GetComponents())
+			{
+				AddComponent(Component);
+			}
+		}
+	};
+
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		if (Blueprint->GeneratedClass)
+		{
+			UObject* DefaultObject = Blueprint->GeneratedClass->GetDefaultObject(false);
+			if (const AActor* Actor = Cast<AActor>(DefaultObject))
+			{
+				AddActor(Actor);
+			}
+			else
+			{
+				AddComponent(Cast<UActorComponent>(DefaultObject));
+			}
+		}
+
+		if (Blueprint->SimpleConstructionScript)
+		{
+			for (const USCS_Node* Node : Blueprint->SimpleConstructionScript->GetAllNodes())
+			{
+				AddComponent(Node ? Node->ComponentTemplate : nullptr);
+			}
+		}
+	}
+	else if (const UWorld* World = Cast<UWorld>(Object))
+	{
+		if (World->PersistentLevel)
+		{
+			for (const AActor* Actor : World->PersistentLevel->Actors)
+			{
+				// External actors are saved and counted as their own packages
+				if (Actor && !Actor->IsPackageExternal())
+				{
+					AddActor(Actor);
+				}
+			}
+		}
+	}
+	else if (const AActor* Actor = Cast<AActor>(Object))
+	{
+		// One file per actor levels, actor is the asset
+		if (Actor->IsPackageExternal())
+		{
+			AddActor(Actor);
+		}
+	}
+
+	// ClassPath=Tag:Count,Tag:Count;ClassPath=...
+	TArray<FString> ClassEntries;
+	for (const TPair<const UClass*, TMap<FName, int32>>& ClassPair : Counts)
+	{
+		FString Entry = ClassPair.Key->GetPathName() + TEXT("=");
+		bool bFirst = true;
+		for (const TPair<FName, int32>& TagPair : ClassPair.Value)
+		{
+			const FString Tag = TagPair.Key.ToString();
+			if (Tag.Contains(TEXT(":")) || Tag.Contains(TEXT(",")) || Tag.Contains(TEXT(";")) || Tag.Contains(TEXT("=")))
+			{
+				continue;
+			}
+
+			Entry += FString::Printf(TEXT("%s%s:%d"), bFirst ? TEXT("") : TEXT(","), *Tag, TagPair.Value);
+			bFirst = false;
+		}
+
+		if (!bFirst)
+		{
+			ClassEntries.Add(MoveTemp(Entry));
+		}
+	}
+
+	// Stable value, so resaving unchanged asset does not look like a change
+	ClassEntries.Sort();
+	return FString::Join(ClassEntries, TEXT(";"));
+}
+
+void FComponentTagUsageIndex::ParseTagValue(const FString& Value, TArray<FTagCount>& OutCounts)
+{
+	TArray<FString> ClassEntries;
+	Value.ParseIntoArray(ClassEntries, TEXT(";"));
+
+	for (const FString& ClassEntry : ClassEntries)
+	{
+		FString ClassPath;
+		FString Tags;
+		if (!ClassEntry.Split(TEXT("="), &ClassPath, &Tags))
+		{
+			continue;
+		}
+
+		TArray<FString> TagEntries;
+		Tags.ParseIntoArray(TagEntries, TEXT(","));
+		for (const FString& TagEntry : TagEntries)
+		{
+			FString Tag;
+			FString Count;
+			if (TagEntry.Split(TEXT(":"), &Tag, &Count, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+			{
+				FTagCount& TagCount = OutCounts.AddDefaulted_GetRef();
+				TagCount.ComponentClass = ClassPath;
+				TagCount.Tag = FName(*Tag);
+				TagCount.Count = FCString::Atoi(*Count);
+			}
+		}
+	}
+}
+
+void FComponentTagUsageIndex::OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& InOutTags)
+{
+	if (Object == nullptr || Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		return;
+	}
+
+	if (Object->IsA<UBlueprint>() || Object->IsA<UWorld>() || Object->IsA<AActor>())
+	{
+		FString Value = MakeTagValue(Object);
+		if (!Value.IsEmpty())
+		{
+			InOutTags.Add(UObject::FAssetRegistryTag(AssetRegistryTagName, MoveTemp(Value), UObject::FAssetRegistryTag::TT_Hidden));
+		}
+	}
+}
+
+void FComponentTagUsageIndex::StartScan()
+{
+	EDITORMISCUTILITIES_SCOPE(TagUsage);
+
+	bScanning = true;
+
+	// Only copying tag values stays on game thread, parsing and counting run in background
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.TagsAndValues.Add(AssetRegistryTagName);
+
+	TArray<TPair<FName, FString>> Values;
+	AssetRegistry.EnumerateAssets(Filter, [&Values](const FAssetData& AssetData)
+	{
+		FString Value;
+		if (AssetData.GetTagValue(AssetRegistryTagName, Value))
+		{
+			Values.Emplace(AssetData.PackageName, MoveTemp(Value));
+		}
+		return true;
+	});
+
+	Async(EAsyncExecution::ThreadPool, [Filename = GetCacheFilename(), Values = MoveTemp(Values)]()
+	{
+		EDITORMISCUTILITIES_SCOPE(TagUsage);
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		TMap<FName, FPackageUsage> Cached;
+		if (TUniquePtr<FArchive> FileReader = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*Filename)))
+		{
+			FNameAsStringProxyArchive Ar(*FileReader);
+			int32 Version = 0;
+			Ar << Version;
+			if (Version == ComponentTagUsageCacheVersion)
+			{
+				Ar << Cached;
+			}
+			if (Ar.IsError())
+			{
+				Cached.Empty();
+			}
+		}
+
+		TMap<FName, FPackageUsage> Usages;
+		Usages.Reserve(Values.Num());
+		int32 NumParsed = 0;
+		for (const TPair<FName, FString>& Pair : Values)
+		{
+			const uint32 ValueHash = FCrc::StrCrc32(*Pair.Value);
+
+			FPackageUsage* Existing = Cached.Find(Pair.Key);
+			if (Existing && Existing->ValueHash == ValueHash)
+			{
+				Usages.Add(Pair.Key, MoveTemp(*Existing));
+				continue;
+			}
+
+			FPackageUsage& Usage = Usages.Add(Pair.Key);
+			Usage.ValueHash = ValueHash;
+			ParseTagValue(Pair.Value, Usage.Counts);
+			NumParsed++;
+		}
+
+		const bool bCacheChanged = NumParsed > 0 || Usages.Num() != Cached.Num();
+		const double ScanTime = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [Usages = MoveTemp(Usages), bCacheChanged, NumParsed, ScanTime]() mutable
+		{
+			FComponentTagUsageIndex& Index = FComponentTagUsageIndex::Get();
+			if (!Index.bInitialized)
+			{
+				return;
+			}
+
+			Index.PackageUsages = MoveTemp(Usages);
+			Index.ClassTagCounts.Empty();
+			for (const TPair<FName, FPackageUsage>& Pair : Index.PackageUsages)
+			{
+				Index.ApplyCounts(Pair.Value, 1);
+			}
+			Index.bDirty = bCacheChanged;
+			Index.bScanning = false;
+			Index.bReady = true;
+
+			UE_LOG(LogEditorMiscUtilities, Log, TEXT("ComponentTagUsage: Indexed %d packages (%d parsed) in %.2f ms"), Index.PackageUsages.Num(), NumParsed, ScanTime * 1000.0);
+
+			TArray<FAssetData> Changes = MoveTemp(Index.PendingChanges);
+			for (const FAssetData& AssetData : Changes)
+			{
+				Index.OnAssetChanged(AssetData);
+			}
+
+			Index.Version++;
+		});
+	});
+}
+
+/** Events of initial discovery are covered by the scan that starts once files are loaded */
+static bool IsDiscoveringAssets()
+{
+	const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+	return AssetRegistry == nullptr || AssetRegistry->IsLoadingAssets();
+}
+
+void FComponentTagUsageIndex::OnAssetChanged(const FAssetData& AssetData)
+{
+	if (IsDiscoveringAssets())
+	{
+		return;
+	}
+
+	if (bScanning)
+	{
+		PendingChanges.Add(AssetData);
+		return;
+	}
+
+	FString Value;
+	if (AssetData.GetTagValue(AssetRegistryTagName, Value))
+	{
+		SetPackageUsage(AssetData.PackageName, &Value);
+	}
+	else if (PackageUsages.Contains(AssetData.PackageName))
+	{
+		SetPackageUsage(AssetData.PackageName, nullptr);
+	}
+}
+
+void FComponentTagUsageIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+	if (IsDiscoveringAssets())
+	{
+		return;
+	}
+
+	if (bScanning)
+	{
+		PendingChanges.Add(AssetData);
+		return;
+	}
+
+	if (PackageUsages.Contains(AssetData.PackageName))
+	{
+		SetPackageUsage(AssetData.PackageName, nullptr);
+	}
+}
+
+void FComponentTagUsageIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (!bScanning)
+	{
+		const FName OldPackageName = *FPackageName::ObjectPathToPackageName(OldObjectPath);
+		if (OldPackageName != AssetData.PackageName && PackageUsages.Contains(OldPackageName))
+		{
+			SetPackageUsage(OldPackageName, nullptr);
+		}
+	}
+
+	OnAssetChanged(AssetData);
+}
+
+void FComponentTagUsageIndex::SetPackageUsage(FName PackageName, const FString* Value)
+{
+	EDITORMISCUTILITIES_SCOPE(TagUsage);
+
+	const uint32 ValueHash = Value ? FCrc::StrCrc32(**Value) : 0;
+
+	FPackageUsage* Existing = PackageUsages.Find(PackageName);
+	if (Existing)
+	{
+		if (Value && Existing->ValueHash == ValueHash)
+		{
+			return;
+		}
+
+		ApplyCounts(*Existing, -1);
+		PackageUsages.Remove(PackageName);
+	}
+
+	if (Value)
+	{
+		FPackageUsage& Usage = PackageUsages.Add(PackageName);
+		Usage.ValueHash = ValueHash;
+		ParseTagValue(*Value, Usage.Counts);
+		ApplyCounts(Usage, 1);
+	}
+
+	bDirty = true;
+	Version++;
+}
+
+void FComponentTagUsageIndex::ApplyCounts(const FPackageUsage& Usage, int32 Sign)
+{
+	for (const FTagCount& TagCount : Usage.Counts)
+	{
+		TMap<FName, int32>& Counts = ClassTagCounts.FindOrAdd(TagCount.ComponentClass);
+		int32& Count = Counts.FindOrAdd(TagCount.Tag);
+		Count += Sign * TagCount.Count;
+
+		if (Count <= 0)
+		{
+			Counts.Remove(TagCount.Tag);
+			if (Counts.Num() == 0)
+			{
+				ClassTagCounts.Remove(TagCount.ComponentClass);
+			}
+		}
+	}
+}
+
+FString FComponentTagUsageIndex::GetCacheFilename() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("EditorMiscUtilities") / TEXT("ComponentTagUsage.bin");
+}
+
+void FComponentTagUsageIndex::SaveCache() const
+{
+	const FString Filename = GetCacheFilename();
+	if (TUniquePtr<FArchive> FileWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Filename)))
+	{
+		FNameAsStringProxyArchive Ar(*FileWriter);
+		int32 Version = ComponentTagUsageCacheVersion;
+		Ar << Version;
+		Ar << const_cast<TMap<FName, FPackageUsage>&>(PackageUsages);
+		bDirty = false;
+	}
+	else
+	{
+		UE_LOG(LogEditorMiscUtilities, Warning, TEXT("ComponentTagUsage: Failed to write %s"), *Filename);
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <AssetRegistry/AssetData.h>
+
+/**
+ * How often each ComponentTag is used per component class across the project.
+ * Blueprints, levels and external actors write their component tags as a hidden asset registry tag on save,
+ * the index reads those tags in background and follows registry updates afterwards.
+ * Per-package results are kept in Saved/EditorMiscUtilities/ComponentTagUsage.bin so unchanged packages are not parsed again.
+ * Assets saved before the plugin was enabled carry no tag and are not counted until resaved
+ */
+class FComponentTagUsageIndex
+{
+public:
+	static FComponentTagUsageIndex& Get();
+
+	static const FName AssetRegistryTagName;
+
+	void Initialize();
+	void Shutdown();
+
+	bool IsReady() const { return bReady; }
+
+	/** Most used tags of class and its parents, highest count first */
+	void GetMostUsedTags(const UClass* ComponentClass, int32 MaxCount, TArray<TPair<FName, int32>>& OutTags) const;
+
+	/** Incremented on game thread when counts change, so users can refresh only what they derived from counts */
+	uint32 GetVersion() const { return Version; }
+
+public:
+	struct FTagCount
+	{
+		FString ComponentClass;
+		FName Tag;
+		int32 Count = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FTagCount& Value)
+		{
+			return Ar << Value.ComponentClass << Value.Tag << Value.Count;
+		}
+	};
+
+	struct FPackageUsage
+	{
+		/** Hash of registry tag value the counts were parsed from */
+		uint32 ValueHash = 0;
+		TArray<FTagCount> Counts;
+
+		friend FArchive& operator<<(FArchive& Ar, FPackageUsage& Value)
+		{
+			return Ar << Value.ValueHash << Value.Counts;
+		}
+	};
+
+	static FString MakeTagValue(const UObject* Object);
+	static void ParseTagValue(const FString& Value, TArray<FTagCount>& OutCounts);
+
+private:
+	void OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& InOutTags);
+
+	void StartScan();
+	void OnAssetChanged(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	void SetPackageUsage(FName PackageName, const FString* Value);
+	void ApplyCounts(const FPackageUsage& Usage, int32 Sign);
+
+	FString GetCacheFilename() const;
+	void SaveCache() const;
+
+	/** Contribution of every package, mirrors cache file */
+	TMap<FName, FPackageUsage> PackageUsages;
+
+	/** Component class path -> tag -> count */
+	TMap<FString, TMap<FName, int32>> ClassTagCounts;
+
+	/** Registry changes seen while background scan was running */
+	TArray<FAssetData> PendingChanges;
+
+	bool bInitialized = false;
+	bool bScanning = false;
+	bool bReady = false;
+	mutable bool bDirty = false;
+
+	uint32 Version = 0;
+
+	FDelegateHandle ExtraTagsHandle;
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+};
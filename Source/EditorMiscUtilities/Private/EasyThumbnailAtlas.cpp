@@ -0,0 +1,208 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailAtlas.h"
+#include "EditorMiscUtilitiesModule.h"
+
+#include <Engine/Texture2D.h>
+#include <ImageCore.h>
+#include <RenderUtils.h>
+
+/** Size of one atlas page in pixels, 4 MB each. Fits 49 padded 128 px icons or about 900 of 32 px */
+static const int32 EasyThumbnailAtlasPageSize = 1024;
+
+/** Pages are never released while editor runs, keep their number bounded. Textures that do not fit are drawn directly */
+static const int32 EasyThumbnailAtlasMaxPages = 4;
+
+/** Edge pixels are repeated around each slot so bilinear filtering does not pick up neighbours */
+static const int32 EasyThumbnailAtlasPadding = 1;
+
+
+FEasyThumbnailAtlas& FEasyThumbnailAtlas::Get()
+{
+	static FEasyThumbnailAtlas Instance;
+	return Instance;
+}
+
+bool FEasyThumbnailAtlas::FindOrAdd(UTexture2D* Texture, FSlot& OutSlot)
+{
+	if (Texture == nullptr || !Texture->Source.IsValid())
+	{
+		return false;
+	}
+
+	// Reimport changes source id, content of the slot is stale then
+	const FGuid SourceId = Texture->Source.GetId();
+
+	FEntry* Entry = Entries.Find(Texture);
+	if (Entry && Entry->SourceId == SourceId)
+	{
+		if (Entry->PageIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const float InvPageSize = 1.0f / EasyThumbnailAtlasPageSize;
+		OutSlot.Page = Pages[Entry->PageIndex].Texture.Get();
+		OutSlot.UV0 = FVector2D(Entry->Rect.Min) * InvPageSize;
+		OutSlot.UV1 = FVector2D(Entry->Rect.Max) * InvPageSize;
+		return true;
+	}
+
+	if (Entry == nullptr)
+	{
+		Entry = &Entries.Add(Texture);
+	}
+	const FIntRect OldRect = Entry->Rect;
+	const int32 OldPageIndex = Entry->PageIndex;
+
+	Entry->SourceId = SourceId;
+	Entry->PageIndex = INDEX_NONE;
+
+	const int32 Width = Texture->Source.GetSizeX();
+	const int32 Height = Texture->Source.GetSizeY();
+	if (Width <= 0 || Height <= 0 || Width > MaxSourceSize || Height > MaxSourceSize)
+	{
+		return false;
+	}
+
+	// Source is read once per slot, unload it again unless someone else had it loaded
+	const bool bSourceWasLoaded = Texture->Source.IsBulkDataLoaded();
+	FImage Source;
+	const bool bHasSource = Texture->Source.GetMipImage(Source, 0, 0, 0);
+	if (!bSourceWasLoaded)
+	{
+		Texture->Source.ReleaseSourceMemory();
+	}
+	if (!bHasSource)
+	{
+		return false;
+	}
+	Source.GammaSpace = Texture->SRGB ? EGammaSpace::sRGB : EGammaSpace::Linear;
+	Source.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+
+	// Same size after reimport reuses the slot, otherwise old slot is abandoned
+	const FIntPoint PaddedSize(Width + 2 * EasyThumbnailAtlasPadding, Height + 2 * EasyThumbnailAtlasPadding);
+	int32 PageIndex = OldPageIndex;
+	FIntPoint Position = OldRect.Min - FIntPoint(EasyThumbnailAtlasPadding);
+	if (PageIndex == INDEX_NONE || OldRect.Size() != FIntPoint(Width, Height))
+	{
+		if (!Allocate(PaddedSize, PageIndex, Position))
+		{
+			UE_LOG(LogEditorMiscUtilities, Verbose, TEXT("EasyThumbnailAtlas: No space for %s"), *Texture->GetPathName());
+			return false;
+		}
+	}
+
+	const FColor* SourcePixels = Source.AsBGRA8().GetData();
+	TArray<FColor> Pixels;
+	Pixels.SetNumUninitialized(PaddedSize.X * PaddedSize.Y);
+	for (int32 Y = 0; Y < PaddedSize.Y; Y++)
+	{
+		const int32 SourceY = FMath::Clamp(Y - EasyThumbnailAtlasPadding, 0, Height - 1);
+		for (int32 X = 0; X < PaddedSize.X; X++)
+		{
+			const int32 SourceX = FMath::Clamp(X - EasyThumbnailAtlasPadding, 0, Width - 1);
+			Pixels[Y * PaddedSize.X + X] = SourcePixels[SourceY * Width + SourceX];
+		}
+	}
+
+	UTexture2D* Page = Pages[PageIndex].Texture.Get();
+	Upload(Page, FIntRect(Position, Position + PaddedSize), MoveTemp(Pixels));
+
+	Entry->PageIndex = PageIndex;
+	Entry->Rect = FIntRect(Position + FIntPoint(EasyThumbnailAtlasPadding), Position + FIntPoint(EasyThumbnailAtlasPadding) + FIntPoint(Width, Height));
+
+	const float InvPageSize = 1.0f / EasyThumbnailAtlasPageSize;
+	OutSlot.Page = Page;
+	OutSlot.UV0 = FVector2D(Entry->Rect.Min) * InvPageSize;
+	OutSlot.UV1 = FVector2D(Entry->Rect.Max) * InvPageSize;
+	return true;
+}
+
+void FEasyThumbnailAtlas::Reset()
+{
+	Pages.Empty();
+	Entries.Empty();
+}
+
+bool FEasyThumbnailAtlas::Allocate(const FIntPoint& Size, int32& OutPageIndex, FIntPoint& OutPosition)
+{
+	// Shelf packing, icons are mostly of a few fixed sizes so waste is small
+	for (int32 PageIndex = 0; PageIndex <= Pages.Num(); PageIndex++)
+	{
+		if (PageIndex == Pages.Num())
+		{
+			if (Pages.Num() >= EasyThumbnailAtlasMaxPages || AddPage() == INDEX_NONE)
+			{
+				return false;
+			}
+		}
+
+		FPage& Page = Pages[PageIndex];
+		for (FShelf& Shelf : Page.Shelves)
+		{
+			if (Size.Y <= Shelf.Height && Shelf.NextX + Size.X <= EasyThumbnailAtlasPageSize)
+			{
+				OutPageIndex = PageIndex;
+				OutPosition = FIntPoint(Shelf.NextX, Shelf.Y);
+				Shelf.NextX += Size.X;
+				return true;
+			}
+		}
+
+		if (Page.NextShelfY + Size.Y <= EasyThumbnailAtlasPageSize)
+		{
+			FShelf& Shelf = Page.Shelves.AddDefaulted_GetRef();
+			Shelf.Y = Page.NextShelfY;
+			Shelf.Height = Size.Y;
+			Shelf.NextX = Size.X;
+			Page.NextShelfY += Size.Y;
+
+			OutPageIndex = PageIndex;
+			OutPosition = FIntPoint(0, Shelf.Y);
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 FEasyThumbnailAtlas::AddPage()
+{
+	UTexture2D* Texture = UTexture2D::CreateTransient(EasyThumbnailAtlasPageSize, EasyThumbnailAtlasPageSize, PF_B8G8R8A8);
+	if (Texture == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	void* Data = Mip.BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memzero(Data, Mip.BulkData.GetBulkDataSize());
+	Mip.BulkData.Unlock();
+
+	Texture->SRGB = true;
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->NeverStream = true;
+	Texture->UpdateResource();
+
+	FPage& Page = Pages.AddDefaulted_GetRef();
+	Page.Texture = TStrongObjectPtr<UTexture2D>(Texture);
+
+	UE_LOG(LogEditorMiscUtilities, Log, TEXT("EasyThumbnailAtlas: Added page %d"), Pages.Num());
+	return Pages.Num() - 1;
+}
+
+void FEasyThumbnailAtlas::Upload(UTexture2D* Page, const FIntRect& Rect, TArray<FColor>&& Pixels)
+{
+	// Only the slot is sent to GPU, region and data are freed by render thread
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+	TArray<FColor>* Data = new TArray<FColor>(MoveTemp(Pixels));
+
+	Page->UpdateTextureRegions(0, 1, Region, Rect.Width() * sizeof(FColor), sizeof(FColor), reinterpret_cast<uint8*>(Data->GetData()),
+		[Data](uint8*, const FUpdateTextureRegion2D* InRegion)
+		{
+			delete Data;
+			delete InRegion;
+		});
+}
@@ -0,0 +1,68 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <UObject/ObjectKey.h>
+#include <UObject/StrongObjectPtr.h>
+
+class UTexture2D;
+
+/**
+ * Small brush textures packed into shared transient pages, so thumbnails using them bind one texture.
+ * Textures are packed on first draw from their source data and repacked when the source changes
+ */
+class FEasyThumbnailAtlas
+{
+public:
+	struct FSlot
+	{
+		UTexture2D* Page = nullptr;
+		FVector2D UV0 = FVector2D::ZeroVector;
+		FVector2D UV1 = FVector2D::UnitVector;
+	};
+
+	/** Larger textures are drawn directly */
+	static constexpr int32 MaxSourceSize = 128;
+
+	static FEasyThumbnailAtlas& Get();
+
+	/** False if texture can not be packed, e.g. too large, no source data or atlas is full */
+	bool FindOrAdd(UTexture2D* Texture, FSlot& OutSlot);
+
+	/** Drop all pages and slots */
+	void Reset();
+
+private:
+	struct FShelf
+	{
+		int32 Y = 0;
+		int32 Height = 0;
+		int32 NextX = 0;
+	};
+
+	struct FPage
+	{
+		TStrongObjectPtr<UTexture2D> Texture;
+		TArray<FShelf> Shelves;
+		int32 NextShelfY = 0;
+	};
+
+	struct FEntry
+	{
+		int32 PageIndex = INDEX_NONE;
+
+		/** Texture pixels without padding */
+		FIntRect Rect;
+
+		/** Source the slot was filled from, INDEX_NONE page means texture was rejected */
+		FGuid SourceId;
+	};
+
+	bool Allocate(const FIntPoint& Size, int32& OutPageIndex, FIntPoint& OutPosition);
+	int32 AddPage();
+	void Upload(UTexture2D* Page, const FIntRect& Rect, TArray<FColor>&& Pixels);
+
+	TArray<FPage> Pages;
+	TMap<TObjectKey<UTexture2D>, FEntry> Entries;
+};
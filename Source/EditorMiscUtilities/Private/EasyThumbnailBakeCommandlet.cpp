@@ -0,0 +1,341 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailBakeCommandlet.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesSettings.h"
+#include "EasyThumbnailRenderer.h"
+#include "EasyThumbnailDrawing.h"
+#include "EasyThumbnailRegistry.h"
+
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Async/ParallelFor.h>
+#include <Engine/Texture2D.h>
+#include <HAL/FileManager.h>
+#include <ImageCore.h>
+#include <Misc/ObjectThumbnail.h>
+#include <Misc/PackageName.h>
+#include <ObjectTools.h>
+#include <ThumbnailRendering/ThumbnailManager.h>
+#include <UObject/SavePackage.h>
+
+
+/** Mean per-channel difference below which stored thumbnail is considered the same, stored ones are lossy compressed */
+static const float EasyThumbnailBakeTolerance = 2.0f;
+
+
+namespace EasyThumbnailBake
+{
+	struct FItem
+	{
+		/** Null while item is drawn from asset registry tags */
+		UObject* Object = nullptr;
+		FAssetData AssetData;
+		FAssetThumbnailSettings Settings;
+
+		FSlateBrush Brush;
+
+		/** Software path only. Linear RGBA32F copy of brush texture source */
+		FImage Source;
+		FVector2D NaturalSize = FVector2D::ZeroVector;
+
+		/** Region of Source drawn by brush, sprites use a slot of their atlas */
+		FVector2D UV0 = FVector2D::ZeroVector;
+		FVector2D UV1 = FVector2D::UnitVector;
+
+		FObjectThumbnail Thumbnail;
+		bool bRendered = false;
+	};
+
+	static void RasterizeItem(FItem& Item, int32 Size)
+	{
+		TArray<FLinearColor> Pixels;
+		EasyThumbnail::RasterizeBackground(Item.Settings, Size, Size, Pixels);
+
+		if (Item.Source.SizeX > 0 && Item.Source.SizeY > 0)
+		{
+			EasyThumbnail::FNineSliceTiles Tiles;
+			if (Item.Brush.DrawAs == ESlateBrushDrawType::Box || Item.Brush.DrawAs == ESlateBrushDrawType::RoundedBox)
+			{
+				EasyThumbnail::BuildNineSliceTiles(Tiles, FVector2D::ZeroVector, FVector2D(Size, Size), Item.NaturalSize, Item.Brush.Margin);
+			}
+			else
+			{
+				Tiles.Add({ FVector2D::ZeroVector, FVector2D(Size, Size), FVector2D(0, 0), FVector2D(1, 1) });
+			}
+			EasyThumbnail::RemapTileUVs(Tiles, Item.UV0, Item.UV1);
+			EasyThumbnail::RasterizeTiles(Tiles, Item.Source, Item.Brush.TintColor.GetSpecifiedColor(), Size, Size, Pixels);
+		}
+
+		Item.Thumbnail.SetImageSize(Size, Size);
+		TArray<uint8>& ImageData = Item.Thumbnail.AccessImageData();
+		ImageData.SetNumUninitialized(Pixels.Num() * sizeof(FColor));
+
+		FColor* Dest = reinterpret_cast<FColor*>(ImageData.GetData());
+		for (int32 Index = 0; Index < Pixels.Num(); Index++)
+		{
+			Dest[Index] = Pixels[Index].ToFColor(true);
+		}
+		Item.bRendered = true;
+	}
+
+	/** Compare with thumbnail stored in package file, without loading the package */
+	static bool IsStoredThumbnailSame(const FItem& Item)
+	{
+		FString Filename;
+		if (!FPackageName::DoesPackageExist(Item.AssetData.PackageName.ToString(), &Filename))
+		{
+			return false;
+		}
+
+		const FName FullName(*Item.AssetData.GetFullName());
+		FThumbnailMap Thumbnails;
+		if (!ThumbnailTools::LoadThumbnailsFromPackage(Filename, { FullName }, Thumbnails))
+		{
+			return false;
+		}
+
+		const FObjectThumbnail* Stored = Thumbnails.Find(FullName);
+		if (Stored == nullptr || Stored->GetImageWidth() != Item.Thumbnail.GetImageWidth() || Stored->GetImageHeight() != Item.Thumbnail.GetImageHeight())
+		{
+			return false;
+		}
+
+		const TArray<uint8>& StoredData = Stored->GetUncompressedImageData();
+		const TArray<uint8>& NewData = Item.Thumbnail.GetUncompressedImageData();
+		if (StoredData.Num() != NewData.Num() || NewData.Num() == 0)
+		{
+			return false;
+		}
+
+		int64 Difference = 0;
+		for (int32 Index = 0; Index < NewData.Num(); Index++)
+		{
+			Difference += FMath::Abs((int32)StoredData[Index] - (int32)NewData[Index]);
+		}
+		return (float)Difference / NewData.Num() <= EasyThumbnailBakeTolerance;
+	}
+
+	static void ReadSource(FItem& Item)
+	{
+		EasyThumbnail::FBrushTexture BrushTexture;
+		if (!EasyThumbnail::ResolveBrushTexture(Item.Brush.GetResourceObject(), BrushTexture))
+		{
+			return;
+		}
+
+		UTexture2D* Texture = BrushTexture.Texture;
+		if (Texture->Source.IsValid() && Texture->Source.GetMipImage(Item.Source, 0, 0, 0))
+		{
+			Item.Source.GammaSpace = Texture->SRGB ? EGammaSpace::sRGB : EGammaSpace::Linear;
+			Item.Source.ChangeFormat(ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+			Item.NaturalSize = BrushTexture.NaturalSize;
+			Item.UV0 = BrushTexture.UV0;
+			Item.UV1 = BrushTexture.UV1;
+		}
+	}
+
+	static bool SavePackage(UPackage* Package)
+	{
+		FString Filename;
+		if (!FPackageName::DoesPackageExist(Package->GetName(), &Filename))
+		{
+			UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailBake: No file for package %s"), *Package->GetName());
+			return false;
+		}
+
+		if (IFileManager::Get().IsReadOnly(*Filename))
+		{
+			UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailBake: %s is read-only, check it out first"), *Filename);
+			return false;
+		}
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.Error = GWarn;
+		return UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs);
+	}
+}
+
+
+UEasyThumbnailBakeCommandlet::UEasyThumbnailBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UEasyThumbnailBakeCommandlet::Main(const FString& Params)
+{
+	using namespace EasyThumbnailBake;
+
+	int32 BatchSize = 64;
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	BatchSize = FMath::Max(BatchSize, 1);
+
+	int32 ThumbnailSize = ThumbnailTools::DefaultThumbnailSize;
+	FParse::Value(*Params, TEXT("Size="), ThumbnailSize);
+	ThumbnailSize = FMath::Clamp(ThumbnailSize, 16, 1024);
+
+	const bool bNoSave = FParse::Param(*Params, TEXT("NoSave"));
+	const bool bSoftware = !FApp::CanEverRender() || FParse::Param(*Params, TEXT("Software"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Assets;
+	TSet<FSoftObjectPath> Visited;
+	for (const TPair<FSoftClassPath, FAssetThumbnailSettings>& Pair : GetDefault<UEditorMiscUtilities>()->AssetThumbnails)
+	{
+		UClass* AssetClass = Pair.Key.TryLoadClass<UObject>();
+		if (AssetClass == nullptr)
+		{
+			UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailBake: Failed to load class %s"), *Pair.Key.ToString());
+			continue;
+		}
+		FEasyThumbnailRegistry::Get().ResolvePending();
+
+		TArray<FAssetData> ClassAssets;
+		AssetRegistry.GetAssetsByClass(AssetClass->GetClassPathName(), ClassAssets, true);
+		for (FAssetData& AssetData : ClassAssets)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(AssetData.GetSoftObjectPath(), &bAlreadyVisited);
+			if (!bAlreadyVisited)
+			{
+				Assets.Add(MoveTemp(AssetData));
+			}
+		}
+	}
+
+	UE_LOG(LogEditorMiscUtilities, Display, TEXT("EasyThumbnailBake: %d assets, batch size %d, %s path"), Assets.Num(), BatchSize, bSoftware ? TEXT("software") : TEXT("RHI"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumBaked = 0;
+	int32 NumSkipped = 0;
+	int32 NumFailed = 0;
+	int32 NumUpToDate = 0;
+
+	FEasyThumbnailRegistry& Registry = FEasyThumbnailRegistry::Get();
+	UThumbnailManager& ThumbnailManager = UThumbnailManager::Get();
+	for (int32 BatchStart = 0; BatchStart < Assets.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, Assets.Num());
+
+		// Loading and brush resolution touch UObjects, keep them on game thread
+		TArray<FItem> Items;
+		Items.Reserve(BatchEnd - BatchStart);
+		for (int32 Index = BatchStart; Index < BatchEnd; Index++)
+		{
+			// Assets saved with brush tags are rasterized without loading them and their dependencies
+			if (bSoftware && !Assets[Index].IsAssetLoaded())
+			{
+				FItem TagItem;
+				if (UEasyThumbnailRenderer::ResolveBrushFromTags(Assets[Index], TagItem.Brush) && Registry.FindSettings(Assets[Index], TagItem.Settings))
+				{
+					if (TagItem.Brush.GetDrawType() == ESlateBrushDrawType::NoDrawType)
+					{
+						NumSkipped++;
+						continue;
+					}
+
+					TagItem.AssetData = Assets[Index];
+					ReadSource(TagItem);
+					Items.Add(MoveTemp(TagItem));
+					continue;
+				}
+			}
+
+			UObject* Object = Assets[Index].GetAsset();
+			FThumbnailRenderingInfo* RenderingInfo = Object ? ThumbnailManager.GetRenderingInfo(Object) : nullptr;
+			UEasyThumbnailRenderer* Renderer = RenderingInfo ? Cast<UEasyThumbnailRenderer>(RenderingInfo->Renderer) : nullptr;
+			if (Renderer == nullptr || !Renderer->CanVisualizeAsset(Object))
+			{
+				NumSkipped++;
+				continue;
+			}
+
+			FSlateBrush Brush;
+			if (!Renderer->ResolveBrush(Object, Brush) || Brush.GetDrawType() == ESlateBrushDrawType::NoDrawType)
+			{
+				NumSkipped++;
+				continue;
+			}
+
+			FItem& Item = Items.AddDefaulted_GetRef();
+			Item.Object = Object;
+			Item.AssetData = Assets[Index];
+			Item.Settings = UEasyThumbnailRenderer::GetClassInfo(Object)->Settings;
+			Item.Brush = Brush;
+
+			if (bSoftware)
+			{
+				ReadSource(Item);
+			}
+		}
+
+		if (bSoftware)
+		{
+			ParallelFor(Items.Num(), [&Items, ThumbnailSize](int32 Index)
+			{
+				RasterizeItem(Items[Index], ThumbnailSize);
+			});
+		}
+		else
+		{
+			for (FItem& Item : Items)
+			{
+				ThumbnailTools::RenderThumbnail(Item.Object, ThumbnailSize, ThumbnailSize, ThumbnailTools::EThumbnailTextureFlushMode::AlwaysFlush, nullptr, &Item.Thumbnail);
+				Item.bRendered = !Item.Thumbnail.IsEmpty();
+			}
+		}
+
+		for (FItem& Item : Items)
+		{
+			if (!Item.bRendered)
+			{
+				NumFailed++;
+				continue;
+			}
+
+			// Package is loaded only when its stored thumbnail is outdated
+			if (Item.Object == nullptr)
+			{
+				if (IsStoredThumbnailSame(Item))
+				{
+					NumUpToDate++;
+					continue;
+				}
+
+				Item.Object = Item.AssetData.GetAsset();
+				if (Item.Object == nullptr)
+				{
+					NumFailed++;
+					continue;
+				}
+			}
+
+			UPackage* Package = Item.Object->GetOutermost();
+			ThumbnailTools::CacheThumbnail(Item.Object->GetFullName(), &Item.Thumbnail, Package);
+
+			if (!bNoSave && !SavePackage(Package))
+			{
+				NumFailed++;
+				continue;
+			}
+			NumBaked++;
+		}
+
+		Items.Empty();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogEditorMiscUtilities, Display, TEXT("EasyThumbnailBake: %d/%d processed, %.1f assets/s"), BatchEnd, Assets.Num(), BatchEnd / FMath::Max(Elapsed, UE_SMALL_NUMBER));
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogEditorMiscUtilities, Display, TEXT("EasyThumbnailBake: Baked %d, up to date %d, skipped %d, failed %d in %.2fs (%.1f assets/s)"), 
+		NumBaked, NumUpToDate, NumSkipped, NumFailed, Elapsed, Assets.Num() / FMath::Max(Elapsed, UE_SMALL_NUMBER));
+
+	return NumFailed > 0 ? 1 : 0;
+}
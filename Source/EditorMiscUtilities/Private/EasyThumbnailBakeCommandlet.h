@@ -0,0 +1,28 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EasyThumbnailBakeCommandlet.generated.h"
+
+
+/**
+ * Renders thumbnails of all assets registered in UEditorMiscUtilities::AssetThumbnails and saves them into packages.
+ * Without RHI (-nullrhi) brushes are rasterized on worker threads from texture source data.
+ * Assets saved with brush tags are rasterized without loading and loaded only if their stored thumbnail changed.
+ *
+ * Usage: -run=EasyThumbnailBake [-BatchSize=64] [-Size=256] [-Software] [-NoSave]
+ */
+UCLASS()
+class UEasyThumbnailBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEasyThumbnailBakeCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
@@ -0,0 +1,450 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailCache.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesSettings.h"
+#include "EasyThumbnailDrawing.h"
+
+#include <Async/Async.h>
+#include <CanvasTypes.h>
+#include <Engine/Texture2D.h>
+#include <Materials/Material.h>
+#include <Materials/MaterialInstance.h>
+#include <Hash/CityHash.h>
+#include <HAL/FileManager.h>
+#include <Misc/App.h>
+#include <IImageWrapper.h>
+#include <IImageWrapperModule.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Modules/ModuleManager.h>
+#include <RenderingThread.h>
+#include <RHIGPUReadback.h>
+#include <Styling/SlateBrush.h>
+#include <UnrealClient.h>
+
+/** Bump to invalidate all stored thumbnails when drawing code changes */
+static const int32 EasyThumbnailCacheVersion = 2;
+
+/** Number of decoded thumbnails kept alive in memory */
+static const int32 EasyThumbnailCacheMemoryEntries = 512;
+
+/** Size of images kept on disk. Least recently used ones are deleted at startup while it is exceeded */
+static const int64 EasyThumbnailCacheMaxDiskSize = 256ll * 1024 * 1024;
+
+/** Seconds after which a readback that never completed is dropped */
+static const double EasyThumbnailReadbackTimeout = 5.0;
+
+
+FEasyThumbnailCache& FEasyThumbnailCache::Get()
+{
+	static FEasyThumbnailCache Instance;
+	return Instance;
+}
+
+FEasyThumbnailCache::FEasyThumbnailCache()
+	: CacheDir(FPaths::ProjectSavedDir() / TEXT("EasyThumbnailCache"))
+	, Textures(EasyThumbnailCacheMemoryEntries)
+{
+	StartDiskScan();
+}
+
+FString FEasyThumbnailCache::MakeKey(const FSlateBrush& Brush, const FAssetThumbnailSettings& Settings, uint32 Width, uint32 Height)
+{
+	UObject* Resource = Brush.GetResourceObject();
+	if (Resource == nullptr)
+	{
+		return FString();
+	}
+
+	FString Description = FString::Printf(TEXT("%d|%s|%d|%d|%f,%f,%f,%f|%f,%f|%s|%d|%d|%s|%u|%u"),
+		EasyThumbnailCacheVersion,
+		*Resource->GetPathName(),
+		(int32)Brush.DrawAs,
+		(int32)Brush.Tiling,
+		Brush.Margin.Left, Brush.Margin.Top, Brush.Margin.Right, Brush.Margin.Bottom,
+		Brush.ImageSize.X, Brush.ImageSize.Y,
+		*Brush.TintColor.GetSpecifiedColor().ToString(),
+		Settings.bDrawChecker ? 1 : 0,
+		Settings.CheckerDensity,
+		*Settings.BackgroundColor.ToString(),
+		Width,
+		Height);
+
+	// Atlas slots key on the region and the atlas texture they draw from
+	EasyThumbnail::FBrushTexture BrushTexture;
+	UTexture* Texture = Cast<UTexture>(Resource);
+	if (!Texture && EasyThumbnail::ResolveBrushTexture(Resource, BrushTexture))
+	{
+		Texture = BrushTexture.Texture;
+		Description += FString::Printf(TEXT("|%s|%s|%s"), *Texture->GetPathName(), *BrushTexture.UV0.ToString(), *BrushTexture.UV1.ToString());
+	}
+
+#if WITH_EDITORONLY_DATA
+	// Source id changes on reimport, so content edits of the texture invalidate the entry
+	if (Texture)
+	{
+		Description += TEXT("|") + Texture->Source.GetId().ToString();
+	}
+#endif
+
+	if (const UMaterialInterface* Material = Cast<UMaterialInterface>(Resource))
+	{
+		Description += FString::Printf(TEXT("|%u"), HashMaterial(Material));
+	}
+
+	// Computed on every draw, so a fast non-cryptographic hash
+	const uint64 Hash = CityHash64(reinterpret_cast<const char*>(*Description), Description.Len() * sizeof(TCHAR));
+	return FString::Printf(TEXT("%016llx"), Hash);
+}
+
+FString FEasyThumbnailCache::GetCacheFilename(const FString& Key) const
+{
+	return CacheDir / Key.Left(2) / Key + TEXT(".png");
+}
+
+UTexture2D* FEasyThumbnailCache::Find(const FString& Key, bool& bOutLoading)
+{
+	bOutLoading = false;
+
+	if (const TStrongObjectPtr<UTexture2D>* Cached = Textures.FindAndTouch(Key))
+	{
+		return Cached->Get();
+	}
+
+	if (LoadingKeys.Contains(Key))
+	{
+		bOutLoading = true;
+	}
+	else if (DiskKeys.Contains(Key))
+	{
+		LoadAsync(Key);
+		bOutLoading = true;
+	}
+	return nullptr;
+}
+
+void FEasyThumbnailCache::LoadAsync(const FString& Key)
+{
+	LoadingKeys.Add(Key);
+
+	IImageWrapperModule* ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+	Async(EAsyncExecution::ThreadPool, [this, ImageWrapperModule, Key, Filename = GetCacheFilename(Key), LoadGeneration = Generation]()
+	{
+		TArray64<uint8> BGRA;
+		int32 Width = 0;
+		int32 Height = 0;
+
+		TArray<uint8> Compressed;
+		if (FFileHelper::LoadFileToArray(Compressed, *Filename, FILEREAD_Silent))
+		{
+			TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(EImageFormat::PNG);
+			if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(Compressed.GetData(), Compressed.Num()) && ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, BGRA))
+			{
+				Width = ImageWrapper->GetWidth();
+				Height = ImageWrapper->GetHeight();
+
+				// Modification time orders files for pruning
+				IFileManager::Get().SetTimeStamp(*Filename, FDateTime::UtcNow());
+			}
+			else
+			{
+				UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailCache: Failed to decode %s, discarding"), *Filename);
+				IFileManager::Get().Delete(*Filename);
+				BGRA.Reset();
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [this, Key, Width, Height, LoadGeneration, BGRA = MoveTemp(BGRA)]()
+		{
+			if (LoadGeneration != Generation)
+			{
+				return;
+			}
+
+			LoadingKeys.Remove(Key);
+			if (CreateTexture(Key, Width, Height, BGRA) == nullptr)
+			{
+				DiskKeys.Remove(Key);
+			}
+		});
+	});
+}
+
+void FEasyThumbnailCache::StartDiskScan()
+{
+	Async(EAsyncExecution::ThreadPool, [this, CacheDir = CacheDir]()
+	{
+		struct FStoredImage
+		{
+			FString Filename;
+			int64 Size;
+			FDateTime Time;
+		};
+
+		TArray<FStoredImage> Images;
+		int64 TotalSize = 0;
+		IFileManager::Get().IterateDirectoryStatRecursively(*CacheDir, [&Images, &TotalSize](const TCHAR* Filename, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && FPaths::GetExtension(Filename) == TEXT("png"))
+			{
+				Images.Add({ Filename, StatData.FileSize, StatData.ModificationTime });
+				TotalSize += StatData.FileSize;
+			}
+			return true;
+		});
+
+		if (TotalSize > EasyThumbnailCacheMaxDiskSize)
+		{
+			// Most recently used first, loads touch their file
+			Images.Sort([](const FStoredImage& A, const FStoredImage& B) { return A.Time > B.Time; });
+
+			int32 NumDeleted = 0;
+			while (TotalSize > EasyThumbnailCacheMaxDiskSize && Images.Num() > 0)
+			{
+				const FStoredImage Image = Images.Pop(false);
+				IFileManager::Get().Delete(*Image.Filename);
+				TotalSize -= Image.Size;
+				NumDeleted++;
+			}
+			UE_LOG(LogEditorMiscUtilities, Log, TEXT("EasyThumbnailCache: Deleted %d least recently used images to stay under %lld MB"), NumDeleted, EasyThumbnailCacheMaxDiskSize / (1024 * 1024));
+		}
+
+		TSet<FString> Keys;
+		Keys.Reserve(Images.Num());
+		for (const FStoredImage& Image : Images)
+		{
+			Keys.Add(FPaths::GetBaseFilename(Image.Filename));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [this, Keys = MoveTemp(Keys)]()
+		{
+			// Images stored while scanning are already in
+			DiskKeys.Append(Keys);
+		});
+	});
+}
+
+UTexture2D* FEasyThumbnailCache::FindInMemory(const FString& Key)
+{
+	const TStrongObjectPtr<UTexture2D>* Cached = Textures.FindAndTouch(Key);
+	return Cached ? Cached->Get() : nullptr;
+}
+
+uint32 FEasyThumbnailCache::HashMaterial(const UMaterialInterface* Material)
+{
+	if (Material == nullptr)
+	{
+		return 0;
+	}
+
+	// Runs on every draw of a material brush, so only ids and values, no names or paths
+	uint32 Hash = 0;
+
+	// State id changes whenever base material is edited and recompiled
+	if (const UMaterial* BaseMaterial = Material->GetMaterial())
+	{
+		Hash = GetTypeHash(BaseMaterial->StateId);
+	}
+
+	for (const UMaterialInstance* Instance = Cast<UMaterialInstance>(Material); Instance; Instance = Cast<UMaterialInstance>(Instance->Parent))
+	{
+		for (const FScalarParameterValue& Parameter : Instance->ScalarParameterValues)
+		{
+			Hash = HashCombine(Hash, HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(Parameter.ParameterValue)));
+		}
+		for (const FVectorParameterValue& Parameter : Instance->VectorParameterValues)
+		{
+			Hash = HashCombine(Hash, HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(Parameter.ParameterValue)));
+		}
+		for (const FTextureParameterValue& Parameter : Instance->TextureParameterValues)
+		{
+			// Lighting guid is regenerated when texture content changes, and survives reload unlike the pointer
+			const FGuid TextureGuid = Parameter.ParameterValue ? Parameter.ParameterValue->GetLightingGuid() : FGuid();
+			Hash = HashCombine(Hash, HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(TextureGuid)));
+		}
+	}
+	return Hash;
+}
+
+void FEasyThumbnailCache::Capture(const FString& Key, FCanvas* Canvas, FRenderTarget* RenderTarget, const FIntRect& Rect, bool bWriteToDisk)
+{
+	if (Key.IsEmpty() || Canvas == nullptr || RenderTarget == nullptr || Rect.Area() <= 0 || !FApp::CanEverRender() || GUsingNullRHI)
+	{
+		return;
+	}
+
+	// Same image is already on its way
+	if (FetchingKeys.Contains(Key) || PendingReadbacks.ContainsByPredicate([&Key](const FPendingReadback& Pending) { return Pending.Key == Key; }))
+	{
+		return;
+	}
+
+	const FTexture2DRHIRef& Texture = RenderTarget->GetRenderTargetTexture();
+	if (!Texture.IsValid() || (Texture->GetFormat() != PF_B8G8R8A8 && Texture->GetFormat() != PF_R8G8B8A8))
+	{
+		return;
+	}
+
+	// Submit drawn batches so the copy below is ordered after them. Only enqueues render commands
+	Canvas->Flush_GameThread();
+
+	FPendingReadback& Pending = PendingReadbacks.AddDefaulted_GetRef();
+	Pending.Key = Key;
+	Pending.Size = Rect.Size();
+	Pending.bWriteToDisk = bWriteToDisk;
+	Pending.Format = Texture->GetFormat();
+	Pending.StartTime = FPlatformTime::Seconds();
+	Pending.Readback = MakeShared<FRHIGPUTextureReadback, ESPMode::ThreadSafe>(TEXT("EasyThumbnailCacheReadback"));
+
+	ENQUEUE_RENDER_COMMAND(EasyThumbnailCacheCopy)([Readback = Pending.Readback, RenderTarget, Rect](FRHICommandListImmediate& RHICmdList)
+	{
+		FRHITexture* Source = RenderTarget->GetRenderTargetTexture();
+		if (Source == nullptr)
+		{
+			return;
+		}
+
+		RHICmdList.Transition(FRHITransitionInfo(Source, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+		Readback->EnqueueCopy(RHICmdList, Source, FIntVector(Rect.Min.X, Rect.Min.Y, 0), 0, FIntVector(Rect.Width(), Rect.Height(), 1));
+		RHICmdList.Transition(FRHITransitionInfo(Source, ERHIAccess::CopySrc, ERHIAccess::RTV));
+	});
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEasyThumbnailCache::Tick));
+	}
+}
+
+bool FEasyThumbnailCache::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = PendingReadbacks.Num() - 1; Index >= 0; Index--)
+	{
+		const FPendingReadback& Pending = PendingReadbacks[Index];
+		if (!Pending.Readback->IsReady())
+		{
+			// Copy was never enqueued, e.g. target was released
+			if (Now - Pending.StartTime > EasyThumbnailReadbackTimeout)
+			{
+				PendingReadbacks.RemoveAtSwap(Index);
+			}
+			continue;
+		}
+
+		// Staging memory is only mapped on render thread, pixels come back to game thread
+		FetchingKeys.Add(Pending.Key);
+		ENQUEUE_RENDER_COMMAND(EasyThumbnailCacheFetch)([this, Pending, ReadbackGeneration = Generation](FRHICommandListImmediate& RHICmdList)
+		{
+			const int32 Width = Pending.Size.X;
+			const int32 Height = Pending.Size.Y;
+
+			TArray64<uint8> BGRA;
+			int32 RowPitchInPixels = 0;
+			if (const uint8* Data = static_cast<const uint8*>(Pending.Readback->Lock(RowPitchInPixels)))
+			{
+				BGRA.SetNumUninitialized((int64)Width * Height * sizeof(FColor));
+				FColor* Dest = reinterpret_cast<FColor*>(BGRA.GetData());
+				for (int32 Y = 0; Y < Height; Y++)
+				{
+					const FColor* Row = reinterpret_cast<const FColor*>(Data) + (int64)Y * RowPitchInPixels;
+					for (int32 X = 0; X < Width; X++)
+					{
+						FColor& Pixel = Dest[(int64)Y * Width + X];
+						Pixel = Row[X];
+						if (Pending.Format == PF_R8G8B8A8)
+						{
+							Swap(Pixel.R, Pixel.B);
+						}
+						Pixel.A = 255;
+					}
+				}
+				Pending.Readback->Unlock();
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [this, Key = Pending.Key, Width, Height, bWriteToDisk = Pending.bWriteToDisk, ReadbackGeneration, BGRA = MoveTemp(BGRA)]() mutable
+			{
+				if (ReadbackGeneration != Generation)
+				{
+					return;
+				}
+
+				FetchingKeys.Remove(Key);
+				Store(Key, Width, Height, MoveTemp(BGRA), bWriteToDisk);
+			});
+		});
+
+		PendingReadbacks.RemoveAtSwap(Index);
+	}
+
+	if (PendingReadbacks.Num() == 0)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FEasyThumbnailCache::Store(const FString& Key, int32 Width, int32 Height, TArray64<uint8>&& BGRA, bool bWriteToDisk)
+{
+	if (CreateTexture(Key, Width, Height, BGRA) == nullptr || !bWriteToDisk)
+	{
+		return;
+	}
+	DiskKeys.Add(Key);
+
+	// Compression and disk write are off the game thread
+	IImageWrapperModule* ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+	Async(EAsyncExecution::ThreadPool, [ImageWrapperModule, Filename = GetCacheFilename(Key), Width, Height, BGRA = MoveTemp(BGRA)]()
+	{
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(EImageFormat::PNG);
+		if (ImageWrapper.IsValid() && ImageWrapper->SetRaw(BGRA.GetData(), BGRA.Num(), Width, Height, ERGBFormat::BGRA, 8))
+		{
+			const TArray64<uint8> Compressed = ImageWrapper->GetCompressed();
+			if (!FFileHelper::SaveArrayToFile(Compressed, *Filename))
+			{
+				UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailCache: Failed to write %s"), *Filename);
+			}
+		}
+	});
+}
+
+void FEasyThumbnailCache::Reset()
+{
+	Generation++;
+	PendingReadbacks.Empty();
+	FetchingKeys.Empty();
+	LoadingKeys.Empty();
+	Textures.Empty();
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+UTexture2D* FEasyThumbnailCache::CreateTexture(const FString& Key, int32 Width, int32 Height, const TArray64<uint8>& BGRA)
+{
+	if (BGRA.Num() != (int64)Width * Height * sizeof(FColor))
+	{
+		return nullptr;
+	}
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
+	if (Texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	void* Data = Mip.BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(Data, BGRA.GetData(), BGRA.Num());
+	Mip.BulkData.Unlock();
+
+	Texture->SRGB = true;
+	Texture->UpdateResource();
+
+	Textures.Add(Key, TStrongObjectPtr<UTexture2D>(Texture));
+	return Texture;
+}
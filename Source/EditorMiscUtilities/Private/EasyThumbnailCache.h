@@ -0,0 +1,96 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Containers/LruCache.h>
+#include <Containers/Ticker.h>
+#include <PixelFormat.h>
+#include <UObject/StrongObjectPtr.h>
+
+struct FSlateBrush;
+struct FAssetThumbnailSettings;
+class FRenderTarget;
+class FCanvas;
+class FRHIGPUTextureReadback;
+class UTexture2D;
+class UMaterialInterface;
+
+/**
+ * Persistent cache of rasterized EasyThumbnailRenderer thumbnails.
+ * Images are stored in Saved/EasyThumbnailCache keyed by a hash of everything that affects the result.
+ * Disk is only touched off the game thread, and least recently used files are pruned at startup
+ */
+class FEasyThumbnailCache
+{
+public:
+	static FEasyThumbnailCache& Get();
+
+	/** Hash of resolved brush, thumbnail settings and requested size. Empty if brush cannot be cached */
+	static FString MakeKey(const FSlateBrush& Brush, const FAssetThumbnailSettings& Settings, uint32 Width, uint32 Height);
+
+	/** Changes whenever drawn result of material may change: base material state or any instance parameter. Identity of material itself is not included */
+	static uint32 HashMaterial(const UMaterialInterface* Material);
+
+	/**
+	 * Find cached image in memory. On a miss, an image stored on disk is read and decoded in background,
+	 * bOutLoading is set while it is and a later call returns it
+	 */
+	UTexture2D* Find(const FString& Key, bool& bOutLoading);
+
+	/** Find cached image in memory only, never touches disk */
+	UTexture2D* FindInMemory(const FString& Key);
+
+	/**
+	 * Copy freshly drawn thumbnail into a GPU readback and store it once the copy completes.
+	 * Submits pending canvas batches but never waits for the GPU, so the entry appears a few frames later
+	 */
+	void Capture(const FString& Key, FCanvas* Canvas, FRenderTarget* RenderTarget, const FIntRect& Rect, bool bWriteToDisk = true);
+
+	/** Drop all images kept in memory and any readbacks or loads in flight. Files on disk are kept */
+	void Reset();
+
+private:
+	FEasyThumbnailCache();
+
+	struct FPendingReadback
+	{
+		FString Key;
+		FIntPoint Size;
+		bool bWriteToDisk = true;
+		EPixelFormat Format = PF_Unknown;
+		double StartTime = 0;
+		TSharedPtr<FRHIGPUTextureReadback, ESPMode::ThreadSafe> Readback;
+	};
+
+	bool Tick(float DeltaTime);
+	void Store(const FString& Key, int32 Width, int32 Height, TArray64<uint8>&& BGRA, bool bWriteToDisk);
+
+	/** List stored images in background, deleting least recently used ones over size cap */
+	void StartDiskScan();
+	void LoadAsync(const FString& Key);
+
+	FString GetCacheFilename(const FString& Key) const;
+	UTexture2D* CreateTexture(const FString& Key, int32 Width, int32 Height, const TArray64<uint8>& BGRA);
+
+	FString CacheDir;
+
+	TLruCache<FString, TStrongObjectPtr<UTexture2D>> Textures;
+
+	/** Copies queued on the GPU, polled on game thread */
+	TArray<FPendingReadback> PendingReadbacks;
+
+	/** Readbacks whose copy is done and whose pixels are being fetched on render thread */
+	TSet<FString> FetchingKeys;
+
+	/** Images on disk. Empty until startup scan finishes, images missed before that are drawn and stored again */
+	TSet<FString> DiskKeys;
+
+	/** Images being read and decoded in background */
+	TSet<FString> LoadingKeys;
+
+	/** Bumped by Reset so that readbacks and loads finishing afterwards are dropped */
+	uint32 Generation = 0;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,213 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailDrawing.h"
+#include "EditorMiscUtilitiesSettings.h"
+
+#include <CanvasItem.h>
+#include <Engine/Texture2D.h>
+#include <ImageCore.h>
+#include <Slate/SlateTextureAtlasInterface.h>
+
+
+void EasyThumbnail::BuildNineSliceTiles(FNineSliceTiles& OutTiles, const FVector2D& Position, const FVector2D& Size, const FVector2D& NaturalSize, const FMargin& Margin)
+{
+	const float Width = Size.X;
+	const float Height = Size.Y;
+
+	const float TopPx = FMath::Clamp<float>(NaturalSize.Y * Margin.Top, 0, Height);
+	const float BottomPx = FMath::Clamp<float>(NaturalSize.Y * Margin.Bottom, 0, Height);
+	const float VerticalCenterPx = FMath::Clamp<float>(Height - TopPx - BottomPx, 0, Height);
+	const float LeftPx = FMath::Clamp<float>(NaturalSize.X * Margin.Left, 0, Width);
+	const float RightPx = FMath::Clamp<float>(NaturalSize.X * Margin.Right, 0, Width);
+	const float HorizontalCenterPx = FMath::Clamp<float>(Width - LeftPx - RightPx, 0, Width);
+
+	// Column and row edges in pixels and UVs
+	const float PosX[3] = { 0, LeftPx, Width - RightPx };
+	const float PosY[3] = { 0, TopPx, Height - BottomPx };
+	const float SizeX[3] = { LeftPx, HorizontalCenterPx, RightPx };
+	const float SizeY[3] = { TopPx, VerticalCenterPx, BottomPx };
+	const float U[4] = { 0, Margin.Left, 1 - Margin.Right, 1 };
+	const float V[4] = { 0, Margin.Top, 1 - Margin.Bottom, 1 };
+
+	OutTiles.Reserve(OutTiles.Num() + 9);
+	for (int32 Row = 0; Row < 3; Row++)
+	{
+		for (int32 Column = 0; Column < 3; Column++)
+		{
+			if (SizeX[Column] <= 0 || SizeY[Row] <= 0)
+			{
+				continue;
+			}
+
+			FTile& Tile = OutTiles.AddDefaulted_GetRef();
+			Tile.Position = Position + FVector2D(PosX[Column], PosY[Row]);
+			Tile.Size = FVector2D(SizeX[Column], SizeY[Row]);
+			Tile.UV0 = FVector2D(U[Column], V[Row]);
+			Tile.UV1 = FVector2D(U[Column + 1], V[Row + 1]);
+		}
+	}
+}
+
+void EasyThumbnail::AppendTileTriangles(TArray<FCanvasUVTri>& OutTriangles, const FTile& Tile, const FLinearColor& Color)
+{
+	const FVector2D P0 = Tile.Position;
+	const FVector2D P1 = Tile.Position + Tile.Size;
+	const FVector2D UV0 = Tile.UV0;
+	const FVector2D UV1 = Tile.UV1;
+
+	FCanvasUVTri& First = OutTriangles.AddDefaulted_GetRef();
+	First.V0_Pos = FVector2D(P0.X, P0.Y);	First.V0_UV = FVector2D(UV0.X, UV0.Y);	First.V0_Color = Color;
+	First.V1_Pos = FVector2D(P1.X, P0.Y);	First.V1_UV = FVector2D(UV1.X, UV0.Y);	First.V1_Color = Color;
+	First.V2_Pos = FVector2D(P1.X, P1.Y);	First.V2_UV = FVector2D(UV1.X, UV1.Y);	First.V2_Color = Color;
+
+	FCanvasUVTri& Second = OutTriangles.AddDefaulted_GetRef();
+	Second.V0_Pos = FVector2D(P0.X, P0.Y);	Second.V0_UV = FVector2D(UV0.X, UV0.Y);	Second.V0_Color = Color;
+	Second.V1_Pos = FVector2D(P1.X, P1.Y);	Second.V1_UV = FVector2D(UV1.X, UV1.Y);	Second.V1_Color = Color;
+	Second.V2_Pos = FVector2D(P0.X, P1.Y);	Second.V2_UV = FVector2D(UV0.X, UV1.Y);	Second.V2_Color = Color;
+}
+
+void EasyThumbnail::BuildNineSlice(TArray<FCanvasUVTri>& OutTriangles, const FVector2D& Position, const FVector2D& Size, const FVector2D& NaturalSize, const FMargin& Margin, const FLinearColor& Color)
+{
+	FNineSliceTiles Tiles;
+	BuildNineSliceTiles(Tiles, Position, Size, NaturalSize, Margin);
+
+	OutTriangles.Reserve(OutTriangles.Num() + Tiles.Num() * 2);
+	for (const FTile& Tile : Tiles)
+	{
+		AppendTileTriangles(OutTriangles, Tile, Color);
+	}
+}
+
+bool EasyThumbnail::ResolveBrushTexture(UObject* Resource, FBrushTexture& OutTexture)
+{
+	OutTexture = FBrushTexture();
+
+	if (UTexture2D* Texture = Cast<UTexture2D>(Resource))
+	{
+		OutTexture.Texture = Texture;
+		OutTexture.NaturalSize = FVector2D(Texture->GetSurfaceWidth(), Texture->GetSurfaceHeight());
+		return true;
+	}
+
+	// Sprites and other atlas slots draw a region of a shared texture
+	if (const ISlateTextureAtlasInterface* AtlasInterface = Cast<ISlateTextureAtlasInterface>(Resource))
+	{
+		const FSlateAtlasData AtlasData = AtlasInterface->GetSlateAtlasData();
+		UTexture2D* AtlasTexture = Cast<UTexture2D>(AtlasData.AtlasTexture);
+		if (AtlasTexture == nullptr)
+		{
+			return false;
+		}
+
+		OutTexture.Texture = AtlasTexture;
+		OutTexture.UV0 = FVector2D(AtlasData.StartUV);
+		OutTexture.UV1 = FVector2D(AtlasData.StartUV) + FVector2D(AtlasData.SizeUV);
+		OutTexture.NaturalSize = FVector2D(AtlasData.GetSourceDimensions());
+		return true;
+	}
+
+	return false;
+}
+
+void EasyThumbnail::RemapTriangleUVs(TArrayView<FCanvasUVTri> Triangles, const FVector2D& UV0, const FVector2D& UV1)
+{
+	const FVector2D Scale = UV1 - UV0;
+	for (FCanvasUVTri& Triangle : Triangles)
+	{
+		Triangle.V0_UV = UV0 + Triangle.V0_UV * Scale;
+		Triangle.V1_UV = UV0 + Triangle.V1_UV * Scale;
+		Triangle.V2_UV = UV0 + Triangle.V2_UV * Scale;
+	}
+}
+
+void EasyThumbnail::RemapTileUVs(TArrayView<FTile> Tiles, const FVector2D& UV0, const FVector2D& UV1)
+{
+	const FVector2D Scale = UV1 - UV0;
+	for (FTile& Tile : Tiles)
+	{
+		Tile.UV0 = UV0 + Tile.UV0 * Scale;
+		Tile.UV1 = UV0 + Tile.UV1 * Scale;
+	}
+}
+
+int32 EasyThumbnail::GetRequiredMipCount(int32 NumMips, const FIntPoint& TextureSize, uint32 Width, uint32 Height)
+{
+	if (NumMips <= 1 || Width == 0 || Height == 0)
+	{
+		return NumMips;
+	}
+
+	// Each dropped mip halves the size, keep dropping while the next mip still covers the thumbnail
+	const float Ratio = FMath::Min((float)TextureSize.X / Width, (float)TextureSize.Y / Height);
+	const int32 DroppedMips = Ratio > 1.0f ? FMath::FloorToInt(FMath::Log2(Ratio)) : 0;
+	return NumMips - FMath::Clamp(DroppedMips, 0, NumMips - 1);
+}
+
+void EasyThumbnail::RasterizeBackground(const FAssetThumbnailSettings& Settings, int32 Width, int32 Height, TArray<FLinearColor>& OutPixels)
+{
+	OutPixels.SetNumUninitialized(Width * Height);
+
+	if (!Settings.bDrawChecker)
+	{
+		for (FLinearColor& Pixel : OutPixels)
+		{
+			Pixel = Settings.BackgroundColor;
+		}
+		return;
+	}
+
+	// Approximates UThumbnailManager::CheckerboardTexture tiled CheckerDensity times
+	const FLinearColor Light = FLinearColor(FColor(128, 128, 128));
+	const FLinearColor Dark = FLinearColor(FColor(64, 64, 64));
+	const int32 Cells = FMath::Max(Settings.CheckerDensity, 1) * 2;
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		const int32 CellY = Y * Cells / Height;
+		for (int32 X = 0; X < Width; X++)
+		{
+			const int32 CellX = X * Cells / Width;
+			OutPixels[Y * Width + X] = ((CellX + CellY) & 1) ? Dark : Light;
+		}
+	}
+}
+
+void EasyThumbnail::RasterizeTiles(TConstArrayView<FTile> Tiles, const FImage& Source, const FLinearColor& Tint, int32 Width, int32 Height, TArray<FLinearColor>& InOutPixels)
+{
+	check(Source.Format == ERawImageFormat::RGBA32F);
+	check(InOutPixels.Num() == Width * Height);
+
+	if (Source.SizeX <= 0 || Source.SizeY <= 0)
+	{
+		return;
+	}
+
+	const TArrayView64<const FLinearColor> SourcePixels = Source.AsRGBA32F();
+
+	for (const FTile& Tile : Tiles)
+	{
+		const int32 MinX = FMath::Clamp(FMath::FloorToInt32(Tile.Position.X), 0, Width);
+		const int32 MinY = FMath::Clamp(FMath::FloorToInt32(Tile.Position.Y), 0, Height);
+		const int32 MaxX = FMath::Clamp(FMath::CeilToInt32(Tile.Position.X + Tile.Size.X), 0, Width);
+		const int32 MaxY = FMath::Clamp(FMath::CeilToInt32(Tile.Position.Y + Tile.Size.Y), 0, Height);
+
+		for (int32 Y = MinY; Y < MaxY; Y++)
+		{
+			const double AlphaY = (Y + 0.5 - Tile.Position.Y) / Tile.Size.Y;
+			const double V = FMath::Lerp(Tile.UV0.Y, Tile.UV1.Y, AlphaY);
+			const int32 SourceY = FMath::Clamp(FMath::FloorToInt32(V * Source.SizeY), 0, Source.SizeY - 1);
+
+			for (int32 X = MinX; X < MaxX; X++)
+			{
+				const double AlphaX = (X + 0.5 - Tile.Position.X) / Tile.Size.X;
+				const double U = FMath::Lerp(Tile.UV0.X, Tile.UV1.X, AlphaX);
+				const int32 SourceX = FMath::Clamp(FMath::FloorToInt32(U * Source.SizeX), 0, Source.SizeX - 1);
+
+				// Translucent blend, same as SE_BLEND_Translucent on canvas
+				const FLinearColor Color = SourcePixels[(int64)SourceY * Source.SizeX + SourceX] * Tint;
+				FLinearColor& Dest = InOutPixels[Y * Width + X];
+				Dest = FMath::Lerp(Dest, Color, Color.A);
+				Dest.A = 1.0f;
+			}
+		}
+	}
+}
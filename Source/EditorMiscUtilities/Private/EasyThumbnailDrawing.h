@@ -0,0 +1,67 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Layout/Margin.h>
+
+struct FCanvasUVTri;
+struct FImage;
+struct FAssetThumbnailSettings;
+class UTexture2D;
+
+/** Brush geometry shared by canvas and software thumbnail paths */
+namespace EasyThumbnail
+{
+	struct FTile
+	{
+		FVector2D Position;
+		FVector2D Size;
+		FVector2D UV0;
+		FVector2D UV1;
+	};
+
+	/** Tiles of one box brush, never more than nine so they stay off the heap */
+	using FNineSliceTiles = TArray<FTile, TInlineAllocator<9>>;
+
+	/** Split box brush into nine tiles. Zero-area tiles are skipped */
+	void BuildNineSliceTiles(FNineSliceTiles& OutTiles, const FVector2D& Position, const FVector2D& Size, const FVector2D& NaturalSize, const FMargin& Margin);
+
+	void AppendTileTriangles(TArray<FCanvasUVTri>& OutTriangles, const FTile& Tile, const FLinearColor& Color);
+
+	/** Builds all nine tiles of a box brush as one triangle list, so the canvas submits them in a single batch */
+	void BuildNineSlice(TArray<FCanvasUVTri>& OutTriangles, const FVector2D& Position, const FVector2D& Size, const FVector2D& NaturalSize, const FMargin& Margin, const FLinearColor& Color);
+
+	/** True unless [UV0, UV1] covers the whole texture */
+	inline bool IsSubRegion(const FVector2D& UV0, const FVector2D& UV1) { return UV0 != FVector2D::ZeroVector || UV1 != FVector2D::UnitVector; }
+
+	/** Texture region a brush resource draws: whole texture, or a slot of ISlateTextureAtlasInterface like a sprite */
+	struct FBrushTexture
+	{
+		UTexture2D* Texture = nullptr;
+		FVector2D UV0 = FVector2D::ZeroVector;
+		FVector2D UV1 = FVector2D::UnitVector;
+
+		/** Size of region in pixels */
+		FVector2D NaturalSize = FVector2D::ZeroVector;
+
+		bool IsSubRegion() const { return EasyThumbnail::IsSubRegion(UV0, UV1); }
+	};
+
+	/** False if resource is neither a 2D texture nor an atlas slot in one */
+	bool ResolveBrushTexture(UObject* Resource, FBrushTexture& OutTexture);
+
+	/** Map UVs of triangles from whole texture into [UV0, UV1] sub-rect, e.g. atlas slot */
+	void RemapTriangleUVs(TArrayView<FCanvasUVTri> Triangles, const FVector2D& UV0, const FVector2D& UV1);
+
+	void RemapTileUVs(TArrayView<FTile> Tiles, const FVector2D& UV0, const FVector2D& UV1);
+
+	/** Number of top mips needed to draw texture into Width x Height without upscaling any mip */
+	int32 GetRequiredMipCount(int32 NumMips, const FIntPoint& TextureSize, uint32 Width, uint32 Height);
+
+	/** Software path. Fills background as Draw does, pixels are linear */
+	void RasterizeBackground(const FAssetThumbnailSettings& Settings, int32 Width, int32 Height, TArray<FLinearColor>& OutPixels);
+
+	/** Software path. Blends tiles sampled from RGBA32F linear source over pixels */
+	void RasterizeTiles(TConstArrayView<FTile> Tiles, const FImage& Source, const FLinearColor& Tint, int32 Width, int32 Height, TArray<FLinearColor>& InOutPixels);
+}
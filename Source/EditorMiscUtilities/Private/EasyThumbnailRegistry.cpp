@@ -0,0 +1,234 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailRegistry.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Engine/Blueprint.h>
+#include <ThumbnailRendering/ThumbnailManager.h>
+
+
+FEasyThumbnailRegistry& FEasyThumbnailRegistry::Get()
+{
+	static FEasyThumbnailRegistry Instance;
+	return Instance;
+}
+
+void FEasyThumbnailRegistry::Initialize(const TMap<FSoftClassPath, FAssetThumbnailSettings>& AssetThumbnails)
+{
+	EDITORMISCUTILITIES_SCOPE(ThumbnailRegistry);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (const TPair<FSoftClassPath, FAssetThumbnailSettings>& Thumbnail : AssetThumbnails)
+	{
+		if (!Thumbnail.Key.IsValid() || Thumbnail.Value.PropertyOrFunction.IsNone())
+		{
+			UE_LOG(LogEditorMiscUtilities, Error, TEXT("Failed to register EasyThumbnailRenderer: Invalid settings"));
+			continue;
+		}
+
+		if (UClass* Class = Thumbnail.Key.ResolveClass())
+		{
+			Register(Class, Thumbnail.Value);
+		}
+		else
+		{
+			PendingClasses.Add(Thumbnail.Key.GetAssetPath(), Thumbnail.Value);
+		}
+	}
+
+	ExtraTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddRaw(this, &FEasyThumbnailRegistry::OnGetExtraObjectTags);
+
+	if (PendingClasses.Num() > 0)
+	{
+		AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FEasyThumbnailRegistry::OnAssetLoaded);
+		ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FEasyThumbnailRegistry::OnModulesChanged);
+
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FEasyThumbnailRegistry::ResolvePending);
+	}
+
+	// Deferred classes are the ones startup no longer loads
+	EDITORMISCUTILITIES_STARTUP_TIME(ThumbnailRegistry, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	EDITORMISCUTILITIES_COUNT(ThumbnailClassesDeferred, PendingClasses.Num());
+	UE_LOG(LogEditorMiscUtilities, Verbose, TEXT("EasyThumbnailRenderer: Registered %d classes, deferred %d until loaded"), RegisteredClasses.Num(), PendingClasses.Num());
+}
+
+void FEasyThumbnailRegistry::Shutdown()
+{
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraTagsHandle);
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+	AssetLoadedHandle.Reset();
+	ModulesChangedHandle.Reset();
+	FilesLoadedHandle.Reset();
+	ExtraTagsHandle.Reset();
+
+	if (UThumbnailManager* ThumbnailManager = UThumbnailManager::TryGet())
+	{
+		for (const TPair<FTopLevelAssetPath, FEasyThumbnailClassInfo>& Pair : RegisteredClasses)
+		{
+			if (UClass* AssetClass = Pair.Value.TargetClass.Get())
+			{
+				ThumbnailManager->UnregisterCustomRenderer(AssetClass);
+			}
+		}
+	}
+
+	RegisteredClasses.Empty();
+	PendingClasses.Empty();
+}
+
+void FEasyThumbnailRegistry::ResolvePending()
+{
+	EDITORMISCUTILITIES_SCOPE(ThumbnailRegistry);
+
+	for (auto It = PendingClasses.CreateIterator(); It; ++It)
+	{
+		if (UClass* Class = FindObject<UClass>(It.Key()))
+		{
+			const FAssetThumbnailSettings Settings = It.Value();
+			It.RemoveCurrent();
+			Register(Class, Settings);
+		}
+	}
+}
+
+const FEasyThumbnailClassInfo* FEasyThumbnailRegistry::FindClassInfo(const UClass* Class)
+{
+	for (const UClass* It = Class; It; It = It->GetSuperClass())
+	{
+		FEasyThumbnailClassInfo* Info = RegisteredClasses.Find(It->GetClassPathName());
+		if (Info == nullptr)
+		{
+			continue;
+		}
+
+		// Recompiled blueprint replaces class along with its properties and functions
+		if (Info->TargetClass.Get() != It)
+		{
+			const FAssetThumbnailSettings Settings = Info->Settings;
+			if (!UEasyThumbnailRenderer::MakeClassInfo(const_cast<UClass*>(It), Settings, *Info))
+			{
+				Info->TargetClass = const_cast<UClass*>(It);
+				Info->ThumbnailProperty = nullptr;
+				Info->ThumbnailFunction = nullptr;
+			}
+		}
+
+		return Info->IsValid() ? Info : nullptr;
+	}
+	return nullptr;
+}
+
+bool FEasyThumbnailRegistry::FindSettings(const FAssetData& AssetData, FAssetThumbnailSettings& OutSettings) const
+{
+	TArray<FTopLevelAssetPath> Classes;
+	Classes.Add(AssetData.AssetClassPath);
+
+	TArray<FTopLevelAssetPath> Ancestors;
+	IAssetRegistry::GetChecked().GetAncestorClassNames(AssetData.AssetClassPath, Ancestors);
+	Classes.Append(Ancestors);
+
+	for (const FTopLevelAssetPath& ClassPath : Classes)
+	{
+		if (const FEasyThumbnailClassInfo* Info = RegisteredClasses.Find(ClassPath))
+		{
+			OutSettings = Info->Settings;
+			return true;
+		}
+		if (const FAssetThumbnailSettings* Settings = PendingClasses.Find(ClassPath))
+		{
+			OutSettings = *Settings;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FEasyThumbnailRegistry::Register(UClass* Class, const FAssetThumbnailSettings& Settings)
+{
+	FEasyThumbnailClassInfo Info;
+	if (!UEasyThumbnailRenderer::MakeClassInfo(Class, Settings, Info))
+	{
+		return false;
+	}
+
+	RegisteredClasses.Add(Class->GetClassPathName(), MoveTemp(Info));
+	UThumbnailManager::Get().RegisterCustomRenderer(Class, UEasyThumbnailRenderer::StaticClass());
+	return true;
+}
+
+bool FEasyThumbnailRegistry::TryRegisterPending(UClass* Class)
+{
+	FAssetThumbnailSettings Settings;
+	if (Class == nullptr || !PendingClasses.RemoveAndCopyValue(Class->GetClassPathName(), Settings))
+	{
+		return false;
+	}
+
+	UE_LOG(LogEditorMiscUtilities, Verbose, TEXT("EasyThumbnailRenderer: Registering deferred class %s"), *Class->GetPathName());
+	return Register(Class, Settings);
+}
+
+void FEasyThumbnailRegistry::OnAssetLoaded(UObject* Object)
+{
+	if (Object == nullptr || PendingClasses.Num() == 0)
+	{
+		return;
+	}
+
+	EDITORMISCUTILITIES_SCOPE(ThumbnailRegistry);
+
+	// Loaded class or blueprint, otherwise an instance whose class came in with it, e.g. a data asset of a blueprint class
+	UClass* Class = Cast<UClass>(Object);
+	if (Class == nullptr)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(Object);
+		Class = Blueprint ? Blueprint->GeneratedClass : Object->GetClass();
+	}
+
+	// Parents of loaded class are in memory too and may be pending as well
+	for (; Class; Class = Class->GetSuperClass())
+	{
+		TryRegisterPending(Class);
+	}
+}
+
+void FEasyThumbnailRegistry::OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& InOutTags)
+{
+	if (Object == nullptr || Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		return;
+	}
+
+	// Realtime brushes may depend on anything, a saved snapshot would be wrong
+	const FEasyThumbnailClassInfo* Info = FindClassInfo(Object->GetClass());
+	if (Info == nullptr || Info->Settings.UpdateFrequency == EAssetThumbnailUpdateFrequence::Realtime)
+	{
+		return;
+	}
+
+	// Runs during save, so only a brush property is read. Thumbnail functions may run script and are not called here,
+	// assets using them are loaded to be drawn
+	const FProperty* ThumbnailProperty = Info->ThumbnailProperty.Get();
+	if (const FSlateBrush* Brush = ThumbnailProperty ? ThumbnailProperty->ContainerPtrToValuePtr<FSlateBrush>(Object) : nullptr)
+	{
+		UEasyThumbnailRenderer::GetBrushTags(*Brush, InOutTags);
+	}
+}
+
+void FEasyThumbnailRegistry::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// Native classes appear when their module loads
+	if (Reason == EModuleChangeReason::ModuleLoaded && PendingClasses.Num() > 0)
+	{
+		ResolvePending();
+	}
+}
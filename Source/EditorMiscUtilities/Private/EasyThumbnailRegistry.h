@@ -0,0 +1,49 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EasyThumbnailRenderer.h"
+#include <Modules/ModuleManager.h>
+
+/**
+ * Classes configured in UEditorMiscUtilities::AssetThumbnails.
+ * Renderers are registered only once a class is in memory, classes are never loaded to register them
+ */
+class FEasyThumbnailRegistry
+{
+public:
+	static FEasyThumbnailRegistry& Get();
+
+	/** Register loaded classes, defer the rest until they load */
+	void Initialize(const TMap<FSoftClassPath, FAssetThumbnailSettings>& AssetThumbnails);
+	void Shutdown();
+
+	/** Register pending classes that are already in memory. Never loads */
+	void ResolvePending();
+
+	/** Info of nearest registered class in hierarchy */
+	const FEasyThumbnailClassInfo* FindClassInfo(const UClass* Class);
+
+	/** Settings of nearest configured class of unloaded asset, hierarchy comes from asset registry */
+	bool FindSettings(const FAssetData& AssetData, FAssetThumbnailSettings& OutSettings) const;
+
+	int32 GetNumRegistered() const { return RegisteredClasses.Num(); }
+	int32 GetNumPending() const { return PendingClasses.Num(); }
+
+private:
+	bool Register(UClass* Class, const FAssetThumbnailSettings& Settings);
+	bool TryRegisterPending(UClass* Class);
+
+	void OnAssetLoaded(UObject* Object);
+	void OnGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& InOutTags);
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	TMap<FTopLevelAssetPath, FAssetThumbnailSettings> PendingClasses;
+	TMap<FTopLevelAssetPath, FEasyThumbnailClassInfo> RegisteredClasses;
+
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle ExtraTagsHandle;
+};
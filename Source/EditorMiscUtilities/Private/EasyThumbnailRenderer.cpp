@@ -3,50 +3,43 @@
 
 #include "EasyThumbnailRenderer.h"
 #include "EditorMiscUtilitiesModule.h"
-
+#include "EasyThumbnailAtlas.h"
+#include "EasyThumbnailCache.h"
+#include "EasyThumbnailDrawing.h"
+#include "EasyThumbnailRegistry.h"
+#include "EasyThumbnailScheduler.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <AssetRegistry/AssetData.h>
 #include <ThumbnailRendering/ThumbnailManager.h>
 #include <CanvasItem.h>
 #include <CanvasTypes.h>
+#include <Misc/ScopeExit.h>
+#include <Engine/Texture2D.h>
+#include <Materials/MaterialInterface.h>
 
 
-
-UEasyThumbnailRenderer::FEasyThumbnailRendererOptions UEasyThumbnailRenderer::InitializationData;
+const FName UEasyThumbnailRenderer::BrushResourceTag = TEXT("EasyThumbnail.Resource");
+const FName UEasyThumbnailRenderer::BrushDrawAsTag = TEXT("EasyThumbnail.DrawAs");
+const FName UEasyThumbnailRenderer::BrushMarginTag = TEXT("EasyThumbnail.Margin");
+const FName UEasyThumbnailRenderer::BrushTintTag = TEXT("EasyThumbnail.Tint");
 
 UEasyThumbnailRenderer::UEasyThumbnailRenderer()
 {	
 	if(!HasAnyFlags(RF_ClassDefaultObject))
 	{
-		if (InitializationData.bWaiting)
-		{
-			InitializationData.bWaiting = false;
-
-			TargetClass = InitializationData.TargetClass;
-			ThumbnailProperty = InitializationData.ThumbnailProperty;
-			ThumbnailFunction = InitializationData.ThumbnailFunction;
-			Settings = InitializationData.Settings;
-		}
-		else
-		{
-			UE_LOG(LogEditorMiscUtilities, Error, TEXT("Failed to register EasyThumbnailRenderer: No initialization data"));
-		}
+		PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UEasyThumbnailRenderer::OnObjectPropertyChanged);
+		PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UEasyThumbnailRenderer::OnPostGarbageCollect);
 	}
 }
 
-bool UEasyThumbnailRenderer::TryRegisterForClass(class UThumbnailManager& Manager, FSoftClassPath ClassPath, const FAssetThumbnailSettings& Settings)
+bool UEasyThumbnailRenderer::MakeClassInfo(UClass* AssetClass, const FAssetThumbnailSettings& Settings, FEasyThumbnailClassInfo& OutInfo)
 {
-	if (!ClassPath.IsValid() || Settings.PropertyOrFunction.IsNone())
+	if (AssetClass == nullptr || Settings.PropertyOrFunction.IsNone())
 	{
 		UE_LOG(LogEditorMiscUtilities, Error, TEXT("Failed to register EasyThumbnailRenderer: Invalid settings"));
 		return false;
 	}
-	
-	UClass* AssetClass = ClassPath.TryLoadClass<UObject>();
-	if (AssetClass == nullptr)
-	{
-		UE_LOG(LogEditorMiscUtilities, Error, TEXT("Failed to register EasyThumbnailRenderer: Invalid class"));
-		return false;
-	}
-
 
 	FProperty* SourceProperty = nullptr;
 	UFunction* SourceFunction = nullptr;
@@ -102,54 +95,265 @@ bool UEasyThumbnailRenderer::TryRegisterForClass(class UThumbnailManager& Manage
 		UE_LOG(LogEditorMiscUtilities, Error, TEXT("Failed to register EasyThumbnailRenderer for %s: PropertyOrFunction %s not found"), *GetNameSafe(AssetClass), *Settings.PropertyOrFunction.ToString());
 		return false;
 	}
-	InitializationData.bWaiting = true;
-	InitializationData.TargetClass = AssetClass;
-	InitializationData.ThumbnailProperty = SourceProperty;
-	InitializationData.ThumbnailFunction = SourceFunction;
-	InitializationData.Settings = Settings;
-
-	Manager.RegisterCustomRenderer(AssetClass, UEasyThumbnailRenderer::StaticClass());
-	InitializationData.bWaiting = false;
+	OutInfo.TargetClass = AssetClass;
+	OutInfo.ThumbnailProperty = SourceProperty;
+	OutInfo.ThumbnailFunction = SourceFunction;
+	// BlueprintNativeEvent is native too, but its Blueprint override is only reached through ProcessEvent
+	OutInfo.bNativeThumbnailFunction = SourceFunction && SourceFunction->HasAnyFunctionFlags(FUNC_Native) && !SourceFunction->HasAnyFunctionFlags(FUNC_Event);
+	OutInfo.Settings = Settings;
 
 	return true;
 }
 
-EThumbnailRenderFrequency UEasyThumbnailRenderer::GetThumbnailRenderFrequency(UObject* Object) const
+const FEasyThumbnailClassInfo* UEasyThumbnailRenderer::GetClassInfo(const UObject* Object)
 {
-	return static_cast<EThumbnailRenderFrequency>(Settings.UpdateFrequency);
+	return Object ? FEasyThumbnailRegistry::Get().FindClassInfo(Object->GetClass()) : nullptr;
 }
 
-bool UEasyThumbnailRenderer::CanVisualizeAsset(UObject* Object)
-{	
-	return TargetClass && Object->IsA(TargetClass) && (ThumbnailProperty.IsValid() || ThumbnailFunction.IsValid());
+void UEasyThumbnailRenderer::BeginDestroy()
+{
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+	PropertyChangedHandle.Reset();
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+	CachedBrushes.Empty();
+	PendingStreaming.Empty();
+	PendingCacheLoads.Empty();
+	RedrawStates.Empty();
+
+	Super::BeginDestroy();
 }
 
-void UEasyThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget*, FCanvas* Canvas, bool bAdditionalViewFamily)
-{		
-	FSlateBrush Brush;
+void UEasyThumbnailRenderer::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UEasyThumbnailRenderer* This = CastChecked<UEasyThumbnailRenderer>(InThis);
 
-	if (ThumbnailProperty.IsValid())
+	// Memoized brushes keep their resources alive, same as the brush on the asset does
+	for (TPair<TWeakObjectPtr<UObject>, FSlateBrush>& Pair : This->CachedBrushes)
 	{
-		FSlateBrush* ThumbnailBrushPtr = ThumbnailProperty->ContainerPtrToValuePtr<FSlateBrush>(Object);
+		Collector.AddPropertyReferences(FSlateBrush::StaticStruct(), &Pair.Value, This);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+bool UEasyThumbnailRenderer::ResolveBrush(UObject* Object, FSlateBrush& OutBrush)
+{
+	const FEasyThumbnailClassInfo* Info = GetClassInfo(Object);
+	if (Info == nullptr)
+	{
+		return false;
+	}
+
+	if (FProperty* ThumbnailProperty = Info->ThumbnailProperty.Get())
+	{
+		const FSlateBrush* ThumbnailBrushPtr = ThumbnailProperty->ContainerPtrToValuePtr<FSlateBrush>(Object);
 		if (ThumbnailBrushPtr)
 		{
-			Brush = *ThumbnailBrushPtr;
+			OutBrush = *ThumbnailBrushPtr;
+			return true;
 		}
 	}
-	else if (ThumbnailFunction.IsValid())
+	else if (UFunction* ThumbnailFunction = Info->ThumbnailFunction.Get())
 	{
-		FSlateBrush Value;
-		Object->ProcessEvent(ThumbnailFunction.Get(), &Brush);
+		// Realtime thumbnails may depend on anything, always call them
+		const bool bMemoize = Info->Settings.UpdateFrequency != EAssetThumbnailUpdateFrequence::Realtime;
+		if (bMemoize)
+		{
+			if (const FSlateBrush* Cached = CachedBrushes.Find(Object))
+			{
+				OutBrush = *Cached;
+				return true;
+			}
+		}
+
+		CallThumbnailFunction(Object, ThumbnailFunction, Info->bNativeThumbnailFunction, OutBrush);
+
+		if (bMemoize)
+		{
+			CachedBrushes.Add(Object, OutBrush);
+		}
+		return true;
 	}
 
+	return false;
+}
 
-	if (Brush.GetDrawType() == ESlateBrushDrawType::NoDrawType)
-	{			
+void UEasyThumbnailRenderer::GetBrushTags(const FSlateBrush& Brush, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+	const UObject* Resource = Brush.GetResourceObject();
+	const FString DrawAs = StaticEnum<ESlateBrushDrawType::Type>()->GetNameStringByValue(Brush.DrawAs);
+	const FString Margin = FString::Printf(TEXT("%f,%f,%f,%f"), Brush.Margin.Left, Brush.Margin.Top, Brush.Margin.Right, Brush.Margin.Bottom);
+
+	OutTags.Add(UObject::FAssetRegistryTag(BrushResourceTag, Resource ? Resource->GetPathName() : FString(), UObject::FAssetRegistryTag::TT_Hidden));
+	OutTags.Add(UObject::FAssetRegistryTag(BrushDrawAsTag, DrawAs, UObject::FAssetRegistryTag::TT_Hidden));
+	OutTags.Add(UObject::FAssetRegistryTag(BrushMarginTag, Margin, UObject::FAssetRegistryTag::TT_Hidden));
+	OutTags.Add(UObject::FAssetRegistryTag(BrushTintTag, Brush.TintColor.GetSpecifiedColor().ToString(), UObject::FAssetRegistryTag::TT_Hidden));
+}
+
+bool UEasyThumbnailRenderer::ResolveBrushFromTags(const FAssetData& AssetData, FSlateBrush& OutBrush)
+{
+	FString Resource, DrawAs, Margin, Tint;
+	if (!AssetData.GetTagValue(BrushResourceTag, Resource) || !AssetData.GetTagValue(BrushDrawAsTag, DrawAs)
+		|| !AssetData.GetTagValue(BrushMarginTag, Margin) || !AssetData.GetTagValue(BrushTintTag, Tint))
+	{
+		return false;
+	}
+
+	const int64 DrawAsValue = StaticEnum<ESlateBrushDrawType::Type>()->GetValueByNameString(DrawAs);
+	TArray<FString> MarginValues;
+	FLinearColor TintColor;
+	if (DrawAsValue == INDEX_NONE || Margin.ParseIntoArray(MarginValues, TEXT(",")) != 4 || !TintColor.InitFromString(Tint))
+	{
+		UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailRenderer: Malformed brush tags on %s"), *AssetData.GetObjectPathString());
+		return false;
+	}
+
+	OutBrush = FSlateBrush();
+	OutBrush.DrawAs = static_cast<ESlateBrushDrawType::Type>(DrawAsValue);
+	OutBrush.Margin = FMargin(FCString::Atof(*MarginValues[0]), FCString::Atof(*MarginValues[1]), FCString::Atof(*MarginValues[2]), FCString::Atof(*MarginValues[3]));
+	OutBrush.TintColor = TintColor;
+
+	// Only the texture is loaded, not the asset with its dependencies
+	if (!Resource.IsEmpty())
+	{
+		UObject* ResourceObject = FSoftObjectPath(Resource).TryLoad();
+		if (ResourceObject == nullptr)
+		{
+			UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailRenderer: Failed to load %s for %s"), *Resource, *AssetData.GetObjectPathString());
+			return false;
+		}
+		OutBrush.SetResourceObject(ResourceObject);
+	}
+	return true;
+}
+
+void UEasyThumbnailRenderer::CallThumbnailFunction(UObject* Object, UFunction* Function, bool bNative, FSlateBrush& OutBrush)
+{
+	if (bNative)
+	{
+		// Brush is the only parameter, so it is the whole parameter block
+		FFrame Stack(Object, Function, &OutBrush, nullptr, Function->ChildProperties);
+		Function->Invoke(Object, Stack, Function->ReturnValueOffset != MAX_uint16 ? &OutBrush : nullptr);
+	}
+	else
+	{
+		Object->ProcessEvent(Function, &OutBrush);
+	}
+}
+
+void UEasyThumbnailRenderer::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (CachedBrushes.Num() == 0)
+	{
 		return;
 	}
 
-	UTexture2D* Texture = Cast<UTexture2D>(Brush.GetResourceObject());
+	// Subobject edits (e.g. instanced properties) affect the owning asset too
+	for (UObject* Outer = Object; Outer; Outer = Outer->GetOuter())
+	{
+		if (CachedBrushes.Remove(Outer) > 0)
+		{
+			break;
+		}
+	}
+}
+
+void UEasyThumbnailRenderer::OnPostGarbageCollect()
+{
+	// Release resources of brushes whose objects are gone, they are collected on next pass
+	for (auto It = CachedBrushes.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = PendingStreaming.CreateIterator(); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = PendingCacheLoads.CreateIterator(); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = RedrawStates.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
 
+bool UEasyThumbnailRenderer::RequestMips(UObject* Object, UTexture2D* Texture, const FVector2D& RegionSize, const FSlateBrush& Brush, uint32 Width, uint32 Height)
+{
+	if (!Texture->IsStreamable())
+	{
+		return true;
+	}
+
+	// Box corners are drawn at natural size, so they need the full texture
+	const bool bNaturalSize = Brush.DrawAs == ESlateBrushDrawType::Box || Brush.DrawAs == ESlateBrushDrawType::RoundedBox;
+	const int32 NumMips = Texture->GetNumMips();
+	const int32 RequiredMips = bNaturalSize ? NumMips : EasyThumbnail::GetRequiredMipCount(NumMips, FIntPoint(FMath::CeilToInt(RegionSize.X), FMath::CeilToInt(RegionSize.Y)), Width, Height);
+
+	if (Texture->GetNumResidentMips() < RequiredMips && !Texture->HasPendingInitOrStreaming())
+	{
+		// Plain request, not forced residency, streamer is free to drop the mips once nothing draws them
+		Texture->StreamIn(RequiredMips, true);
+	}
+
+	// Nothing redraws a saved or commandlet thumbnail later, so wait for the mips instead of keeping a low-res image
+	if (IsFinalDraw() && Texture->HasPendingInitOrStreaming())
+	{
+		Texture->WaitForStreaming();
+	}
+
+	if (Texture->GetNumResidentMips() >= RequiredMips)
+	{
+		PendingStreaming.Remove(Object);
+		return true;
+	}
+
+	PendingStreaming.Add(Object);
+	return false;
+}
+
+bool UEasyThumbnailRenderer::IsFinalDraw()
+{
+	// Package thumbnails are generated while the package is being saved
+	return IsRunningCommandlet() || IsSavingPackage();
+}
+
+EThumbnailRenderFrequency UEasyThumbnailRenderer::GetThumbnailRenderFrequency(UObject* Object) const
+{
+	// Redraw until texture is streamed in, cached image is loaded or scheduler gets to it, otherwise the placeholder would be kept
+	if (PendingStreaming.Contains(Object) || PendingCacheLoads.Contains(Object) || FEasyThumbnailScheduler::Get().IsQueued(Object))
+	{
+		return EThumbnailRenderFrequency::Realtime;
+	}
+
+	const FEasyThumbnailClassInfo* Info = GetClassInfo(Object);
+	return Info ? static_cast<EThumbnailRenderFrequency>(Info->Settings.UpdateFrequency) : EThumbnailRenderFrequency::OnAssetSave;
+}
+
+bool UEasyThumbnailRenderer::CanVisualizeAsset(UObject* Object)
+{	
+	return GetClassInfo(Object) != nullptr;
+}
+
+static void DrawBackground(FCanvas* Canvas, const FAssetThumbnailSettings& Settings, uint32 Width, uint32 Height)
+{
 	// Draw the background checkboard pattern
 	if (Settings.bDrawChecker)
 	{	
@@ -166,149 +370,197 @@ void UEasyThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Widt
 			0.0f, 0.0f, 1.0f, 1.0f,			
 			Settings.BackgroundColor, nullptr);
 	}
+}
 
-	if (Texture)
+/** Draw image from memory cache, false if it was evicted */
+static bool DrawCachedImage(const FString& Key, int32 X, int32 Y, uint32 Width, uint32 Height, FCanvas* Canvas)
+{
+	UTexture2D* Cached = FEasyThumbnailCache::Get().FindInMemory(Key);
+	if (Cached == nullptr)
 	{
-		switch (Brush.DrawAs)
-		{
-		case ESlateBrushDrawType::Image:
-		{
-			FCanvasTileItem CanvasTile(FVector2D(X, Y), Texture->GetResource(), FVector2D(Width, Height), Brush.TintColor.GetSpecifiedColor());
-			CanvasTile.BlendMode = SE_BLEND_Translucent;
-			CanvasTile.Draw(Canvas);
-		}
-		break;
-		case ESlateBrushDrawType::Border:
-		{
-			FCanvasTileItem CanvasTile(FVector2D(X, Y), Texture->GetResource(), FVector2D(Width, Height), Brush.TintColor.GetSpecifiedColor());
-			CanvasTile.BlendMode = SE_BLEND_Translucent;
-			CanvasTile.Draw(Canvas);
-		}
-		break;
-		case ESlateBrushDrawType::RoundedBox:
-		case ESlateBrushDrawType::Box:
-		{
-			float NaturalWidth = Texture->GetSurfaceWidth();
-			float NaturalHeight = Texture->GetSurfaceHeight();
-
-			float TopPx = FMath::Clamp<float>(NaturalHeight * Brush.Margin.Top, 0, Height);
-			float BottomPx = FMath::Clamp<float>(NaturalHeight * Brush.Margin.Bottom, 0, Height);
-			float VerticalCenterPx = FMath::Clamp<float>(Height - TopPx - BottomPx, 0, Height);
-			float LeftPx = FMath::Clamp<float>(NaturalWidth * Brush.Margin.Left, 0, Width);
-			float RightPx = FMath::Clamp<float>(NaturalWidth * Brush.Margin.Right, 0, Width);
-			float HorizontalCenterPx = FMath::Clamp<float>(Width - LeftPx - RightPx, 0, Width);
-
-			// Top-Left
-			FVector2D TopLeftSize(LeftPx, TopPx);
-			{
-				FVector2D UV0(0, 0);
-				FVector2D UV1(Brush.Margin.Left, Brush.Margin.Top);
+		return false;
+	}
 
-				FCanvasTileItem CanvasTile(FVector2D(X, Y), Texture->GetResource(), TopLeftSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	FCanvasTileItem CanvasTile(FVector2D(X, Y), Cached->GetResource(), FVector2D(Width, Height), FLinearColor::White);
+	CanvasTile.BlendMode = SE_BLEND_Opaque;
+	CanvasTile.Draw(Canvas);
+	return true;
+}
 
-			// Bottom-Left
-			FVector2D BottomLeftSize(LeftPx, BottomPx);
-			{
-				FVector2D UV0(0, 1 - Brush.Margin.Bottom);
-				FVector2D UV1(Brush.Margin.Left, 1);
+void UEasyThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily)
+{		
+	EDITORMISCUTILITIES_SCOPE(ThumbnailDraw);
 
-				FCanvasTileItem CanvasTile(FVector2D(X, Y + Height - BottomPx), Texture->GetResource(), BottomLeftSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	const FEasyThumbnailClassInfo* Info = GetClassInfo(Object);
+	if (Info == nullptr)
+	{
+		return;
+	}
+	// Copy, resolving brush may load classes and grow the registry
+	const FAssetThumbnailSettings Settings = Info->Settings;
+
+	// Throttled objects within their redraw interval get previous image without resolving the brush.
+	// Final draws always reflect current state
+	const bool bLiveUpdates = Settings.UpdateFrequency == EAssetThumbnailUpdateFrequence::Realtime || Settings.UpdateFrequency == EAssetThumbnailUpdateFrequence::OnPropertyChange;
+	const bool bThrottle = bLiveUpdates && (Settings.bSkipUnchangedRedraws || Settings.MinRedrawInterval > 0.0f) && !IsFinalDraw();
+	const double Now = FPlatformTime::Seconds();
+	FRedrawState* RedrawState = bThrottle ? RedrawStates.Find(Object) : nullptr;
+	if (RedrawState && Now - RedrawState->LastDrawTime < Settings.MinRedrawInterval && DrawCachedImage(RedrawState->Key, X, Y, Width, Height, Canvas))
+	{
+		return;
+	}
 
-			// Top-Right
-			FVector2D TopRightSize(RightPx, TopPx);
-			{
-				FVector2D UV0(1 - Brush.Margin.Right, 0);
-				FVector2D UV1(1, Brush.Margin.Top);
+	// Over frame budget only the background is drawn, object stays realtime until it gets its turn
+	FEasyThumbnailScheduler& Scheduler = FEasyThumbnailScheduler::Get();
+	if (!Scheduler.Admit(Object))
+	{
+		DrawBackground(Canvas, Settings, Width, Height);
+		return;
+	}
+	const double DrawStartTime = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		Scheduler.Finish(FPlatformTime::Seconds() - DrawStartTime);
+	};
 
-				FCanvasTileItem CanvasTile(FVector2D(X + Width - RightPx, Y), Texture->GetResource(), TopRightSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	FSlateBrush Brush;
+	ResolveBrush(Object, Brush);
 
-			// Bottom-Right
-			FVector2D BottomRightSize(RightPx, BottomPx);
-			{
-				FVector2D UV0(1 - Brush.Margin.Right, 1 - Brush.Margin.Bottom);
-				FVector2D UV1(1, 1);
+	if (Brush.GetDrawType() == ESlateBrushDrawType::NoDrawType)
+	{			
+		return;
+	}
 
-				FCanvasTileItem CanvasTile(FVector2D(X + Width - RightPx, Y + Height - BottomPx), Texture->GetResource(), BottomRightSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	EasyThumbnail::FBrushTexture BrushTexture;
+	EasyThumbnail::ResolveBrushTexture(Brush.GetResourceObject(), BrushTexture);
 
-			//-----------------------------------------------------------------------
+	// Brush hash plus texture resource, which is recreated when texture content is replaced
+	FString RedrawKey;
+	if (bThrottle)
+	{
+		RedrawKey = FEasyThumbnailCache::MakeKey(Brush, Settings, Width, Height);
+		if (!RedrawKey.IsEmpty())
+		{
+			RedrawKey += FString::Printf(TEXT("|%p"), BrushTexture.Texture ? BrushTexture.Texture->GetResource() : nullptr);
+		}
 
-			// Center-Vertical-Left
-			FVector2D CenterVerticalLeftSize(LeftPx, VerticalCenterPx);
-			{
-				FVector2D UV0(0, Brush.Margin.Top);
-				FVector2D UV1(Brush.Margin.Left, 1 - Brush.Margin.Bottom);
+		if (Settings.bSkipUnchangedRedraws && RedrawState && RedrawState->Key == RedrawKey && DrawCachedImage(RedrawKey, X, Y, Width, Height, Canvas))
+		{
+			RedrawState->LastDrawTime = Now;
+			return;
+		}
+	}
 
-				FCanvasTileItem CanvasTile(FVector2D(X, Y + TopPx), Texture->GetResource(), CenterVerticalLeftSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	EDITORMISCUTILITIES_COUNT(ThumbnailsDrawn, 1);
 
-			// Center-Vertical-Right
-			FVector2D CenterVerticalRightSize(RightPx, VerticalCenterPx);
-			{
-				FVector2D UV0(1 - Brush.Margin.Right, Brush.Margin.Top);
-				FVector2D UV1(1, 1 - Brush.Margin.Bottom);
+	FString CacheKey;
+	if (Settings.bUseDiskCache)
+	{
+		CacheKey = FEasyThumbnailCache::MakeKey(Brush, Settings, Width, Height);
+		bool bLoading = false;
+		UTexture2D* Cached = !CacheKey.IsEmpty() ? FEasyThumbnailCache::Get().Find(CacheKey, bLoading) : nullptr;
 
-				FCanvasTileItem CanvasTile(FVector2D(X + Width - RightPx, Y + TopPx), Texture->GetResource(), CenterVerticalRightSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+		// Background stands in while stored image is read from disk. Final draws cannot wait for it and draw the brush
+		if (bLoading && !IsFinalDraw())
+		{
+			PendingCacheLoads.Add(Object);
+			DrawBackground(Canvas, Settings, Width, Height);
+			return;
+		}
+		PendingCacheLoads.Remove(Object);
 
-			//-----------------------------------------------------------------------
+		if (Cached)
+		{
+			EDITORMISCUTILITIES_COUNT(ThumbnailCacheHits, 1);
+			FCanvasTileItem CanvasTile(FVector2D(X, Y), Cached->GetResource(), FVector2D(Width, Height), FLinearColor::White);
+			CanvasTile.BlendMode = SE_BLEND_Opaque;
+			CanvasTile.Draw(Canvas);
+			return;
+		}
+		EDITORMISCUTILITIES_COUNT(ThumbnailCacheMisses, 1);
+	}
 
-			// Center-Horizontal-Top
-			FVector2D CenterHorizontalTopSize(HorizontalCenterPx, TopPx);
-			{
-				FVector2D UV0(Brush.Margin.Left, 0);
-				FVector2D UV1(1 - Brush.Margin.Right, Brush.Margin.Top);
+	UTexture2D* Texture = BrushTexture.Texture;
+	UMaterialInterface* Material = Cast<UMaterialInterface>(Brush.GetResourceObject());
 
-				FCanvasTileItem CanvasTile(FVector2D(X + LeftPx, Y), Texture->GetResource(), CenterHorizontalTopSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
-			}
+	DrawBackground(Canvas, Settings, Width, Height);
 
-			// Center-Horizontal-Bottom
-			FVector2D CenterHorizontalBottomSize(HorizontalCenterPx, BottomPx);
-			{
-				FVector2D UV0(Brush.Margin.Left, 1 - Brush.Margin.Bottom);
-				FVector2D UV1(1 - Brush.Margin.Right, 1);
+	FTexture* Resource = nullptr;
+	FVector2D NaturalSize = Brush.ImageSize;
+	FVector2D UV0 = BrushTexture.UV0;
+	FVector2D UV1 = BrushTexture.UV1;
+	FEasyThumbnailAtlas::FSlot Slot;
+	if (Texture)
+	{
+		// Small textures come from a shared page, UVs select their slot. Sprites already share their atlas texture
+		Resource = Texture->GetResource();
+		NaturalSize = BrushTexture.NaturalSize;
+		if (Settings.bUseAtlas && !BrushTexture.IsSubRegion() && FEasyThumbnailAtlas::Get().FindOrAdd(Texture, Slot))
+		{
+			Resource = Slot.Page->GetResource();
+			UV0 = Slot.UV0;
+			UV1 = Slot.UV1;
+		}
+		else if (!RequestMips(Object, Texture, BrushTexture.NaturalSize, Brush, Width, Height))
+		{
+			// Draw what is resident but do not store it
+			CacheKey.Reset();
+			RedrawKey.Reset();
 
-				FCanvasTileItem CanvasTile(FVector2D(X + LeftPx, Y + Height - BottomPx), Texture->GetResource(), CenterHorizontalBottomSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
+			if (IsFinalDraw())
+			{
+				UE_LOG(LogEditorMiscUtilities, Warning, TEXT("EasyThumbnailRenderer: %s did not stream in for thumbnail of %s, image is low resolution"), *Texture->GetPathName(), *Object->GetPathName());
 			}
+		}
+	}
 
-			//-----------------------------------------------------------------------
+	// Material is drawn straight into the thumbnail canvas, thumbnail cache keeps the result while HashMaterial is unchanged
+	const FMaterialRenderProxy* MaterialProxy = !Texture && Material ? Material->GetRenderProxy() : nullptr;
 
-			// Center
-			FVector2D CenterSize(HorizontalCenterPx, VerticalCenterPx);
-			{
-				FVector2D UV0(Brush.Margin.Left, Brush.Margin.Top);
-				FVector2D UV1(1 - Brush.Margin.Right, 1 - Brush.Margin.Bottom);
+	if (Resource || MaterialProxy)
+	{
+		auto DrawTile = [&]()
+		{
+			FCanvasTileItem CanvasTile = MaterialProxy
+				? FCanvasTileItem(FVector2D(X, Y), MaterialProxy, FVector2D(Width, Height), UV0, UV1)
+				: FCanvasTileItem(FVector2D(X, Y), Resource, FVector2D(Width, Height), UV0, UV1, Brush.TintColor.GetSpecifiedColor());
+			CanvasTile.BlendMode = SE_BLEND_Translucent;
+			CanvasTile.Draw(Canvas);
+		};
 
-				FCanvasTileItem CanvasTile(FVector2D(X + LeftPx, Y + TopPx), Texture->GetResource(), CenterSize, UV0, UV1, Brush.TintColor.GetSpecifiedColor());
-				CanvasTile.BlendMode = SE_BLEND_Translucent;
-				CanvasTile.Draw(Canvas);
+		switch (Brush.DrawAs)
+		{
+		case ESlateBrushDrawType::Image:
+		{
+			DrawTile();
+		}
+		break;
+		case ESlateBrushDrawType::Border:
+		{
+			DrawTile();
+		}
+		break;
+		case ESlateBrushDrawType::RoundedBox:
+		case ESlateBrushDrawType::Box:
+		{
+			TArray<FCanvasUVTri> Triangles;
+			EasyThumbnail::BuildNineSlice(Triangles, FVector2D(X, Y), FVector2D(Width, Height), NaturalSize, Brush.Margin, Brush.TintColor.GetSpecifiedColor());
+			// Sprite slot, or atlas page slot picked above
+			if (EasyThumbnail::IsSubRegion(UV0, UV1))
+			{
+				EasyThumbnail::RemapTriangleUVs(Triangles, UV0, UV1);
 			}
+
+			// Single batch element for all nine tiles
+			FCanvasTriangleItem CanvasTriangles(Triangles, Resource);
+			CanvasTriangles.MaterialRenderProxy = MaterialProxy;
+			CanvasTriangles.BlendMode = SE_BLEND_Translucent;
+			CanvasTriangles.Draw(Canvas);
 		}
 		break;
 		case ESlateBrushDrawType::NoDrawType:
 		{
-			FCanvasTileItem CanvasTile(FVector2D(X, Y), Texture->GetResource(), FVector2D(Width, Height), Brush.TintColor.GetSpecifiedColor());
-			CanvasTile.BlendMode = SE_BLEND_Translucent;
-			CanvasTile.Draw(Canvas);
+			DrawTile();
 		}
 		break;		
 		default:
@@ -316,5 +568,19 @@ void UEasyThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Widt
 			check(false);
 		}
 	}
-	
+
+	if (!CacheKey.IsEmpty())
+	{
+		FEasyThumbnailCache::Get().Capture(CacheKey, Canvas, RenderTarget, FIntRect(X, Y, X + (int32)Width, Y + (int32)Height));
+	}
+
+	// Kept in memory only, live thumbnails are not worth persisting
+	if (!RedrawKey.IsEmpty())
+	{
+		FEasyThumbnailCache::Get().Capture(RedrawKey, Canvas, RenderTarget, FIntRect(X, Y, X + (int32)Width, Y + (int32)Height), false);
+
+		FRedrawState& State = RedrawStates.FindOrAdd(Object);
+		State.Key = RedrawKey;
+		State.LastDrawTime = Now;
+	}
 }
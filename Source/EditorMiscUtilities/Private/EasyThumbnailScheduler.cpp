@@ -0,0 +1,149 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailScheduler.h"
+#include "EditorMiscUtilitiesModule.h"
+
+#include <UObject/UObjectGlobals.h>
+
+/** Queued object not requested for this long is out of view */
+static const double EasyThumbnailRequestTimeout = 0.5;
+
+/** Weight of the latest draw in the average draw time */
+static const double EasyThumbnailDrawTimeSmoothing = 0.1;
+
+
+FEasyThumbnailScheduler& FEasyThumbnailScheduler::Get()
+{
+	static FEasyThumbnailScheduler Instance;
+	return Instance;
+}
+
+void FEasyThumbnailScheduler::SetFrameBudget(float Seconds)
+{
+	FrameBudget = FMath::Max(Seconds, 0.0f);
+	if (FrameBudget <= 0.0f)
+	{
+		Reset();
+	}
+}
+
+bool FEasyThumbnailScheduler::Admit(const UObject* Object)
+{
+	// Nothing scrolls in commandlets and nobody would request placeholders again.
+	// Thumbnails generated during save go into the package, a placeholder must never be stored there
+	if (FrameBudget <= 0.0f || Object == nullptr || IsRunningCommandlet() || IsSavingPackage())
+	{
+		return true;
+	}
+
+	BeginFrame();
+
+	const TObjectKey<UObject> Key(Object);
+	if (Admitted.Remove(Key) > 0)
+	{
+		Queue.Remove(Key);
+		return true;
+	}
+
+	// Queued objects go first, new ones are drawn directly only while nothing waits
+	const bool bFitsBudget = SpentSeconds + AverageDrawSeconds <= FrameBudget;
+	if (bFitsBudget && Queue.Num() == 0)
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	FRequest& Request = Queue.FindOrAdd(Key);
+	if (Request.FirstRequestTime == 0.0)
+	{
+		Request.FirstRequestTime = Now;
+	}
+	Request.LastRequestTime = Now;
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEasyThumbnailScheduler::Tick));
+	}
+	return false;
+}
+
+void FEasyThumbnailScheduler::Finish(double Seconds)
+{
+	if (FrameBudget <= 0.0f)
+	{
+		return;
+	}
+
+	BeginFrame();
+	SpentSeconds += Seconds;
+	AverageDrawSeconds = FMath::Lerp(AverageDrawSeconds, Seconds, EasyThumbnailDrawTimeSmoothing);
+}
+
+bool FEasyThumbnailScheduler::IsQueued(const UObject* Object) const
+{
+	return Queue.Num() > 0 && Queue.Contains(TObjectKey<UObject>(Object));
+}
+
+void FEasyThumbnailScheduler::Reset()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	Queue.Empty();
+	Admitted.Empty();
+	SpentSeconds = 0.0;
+}
+
+void FEasyThumbnailScheduler::BeginFrame()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SpentSeconds = 0.0;
+	}
+}
+
+bool FEasyThumbnailScheduler::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// Tiles that scrolled out of view stop requesting their thumbnails
+	for (auto It = Queue.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().LastRequestTime > EasyThumbnailRequestTimeout || !It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	Admitted.Reset();
+	if (Queue.Num() == 0)
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	// Most recently requested are on screen now, among them the longest waiting go first
+	TArray<TPair<TObjectKey<UObject>, FRequest>> Requests = Queue.Array();
+	Requests.Sort([Now](const TPair<TObjectKey<UObject>, FRequest>& A, const TPair<TObjectKey<UObject>, FRequest>& B)
+	{
+		const bool bVisibleA = Now - A.Value.LastRequestTime <= EasyThumbnailRequestTimeout * 0.5;
+		const bool bVisibleB = Now - B.Value.LastRequestTime <= EasyThumbnailRequestTimeout * 0.5;
+		if (bVisibleA != bVisibleB)
+		{
+			return bVisibleA;
+		}
+		return A.Value.FirstRequestTime < B.Value.FirstRequestTime;
+	});
+
+	const int32 NumToAdmit = FMath::Max(1, FMath::FloorToInt(FrameBudget / FMath::Max(AverageDrawSeconds, UE_SMALL_NUMBER)));
+	for (int32 Index = 0; Index < Requests.Num() && Index < NumToAdmit; Index++)
+	{
+		Admitted.Add(Requests[Index].Key);
+	}
+
+	UE_LOG(LogEditorMiscUtilities, VeryVerbose, TEXT("EasyThumbnailScheduler: %d queued, %d admitted"), Queue.Num(), Admitted.Num());
+	return true;
+}
@@ -0,0 +1,56 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Containers/Ticker.h>
+#include <UObject/ObjectKey.h>
+
+/**
+ * Limits time spent on EasyThumbnailRenderer draws per frame.
+ * Objects over budget get a placeholder and wait in a queue ordered by how recently they were requested,
+ * visible tiles keep requesting while tiles scrolled out of view stop and are dropped
+ */
+class FEasyThumbnailScheduler
+{
+public:
+	static FEasyThumbnailScheduler& Get();
+
+	/** Seconds per frame spent on full draws, 0 disables scheduling */
+	void SetFrameBudget(float Seconds);
+
+	/** True if object may be drawn now, otherwise it is queued and caller draws a placeholder */
+	bool Admit(const UObject* Object);
+
+	/** Account time of a full draw */
+	void Finish(double Seconds);
+
+	/** Object waits for its turn, its thumbnail must be requested again */
+	bool IsQueued(const UObject* Object) const;
+
+	void Reset();
+
+private:
+	struct FRequest
+	{
+		double FirstRequestTime = 0.0;
+		double LastRequestTime = 0.0;
+	};
+
+	void BeginFrame();
+	bool Tick(float DeltaTime);
+
+	TMap<TObjectKey<UObject>, FRequest> Queue;
+
+	/** Queued objects picked to be drawn this frame */
+	TSet<TObjectKey<UObject>> Admitted;
+
+	float FrameBudget = 0.0f;
+	uint64 BudgetFrame = 0;
+	double SpentSeconds = 0.0;
+
+	/** Running average of a full draw, used to estimate how many queued objects fit into budget */
+	double AverageDrawSeconds = 0.001;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
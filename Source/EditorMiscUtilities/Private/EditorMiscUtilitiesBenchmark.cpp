@@ -0,0 +1,402 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EditorMiscUtilitiesBenchmark.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesSettings.h"
+#include "ComponentTagCustomization.h"
+#include "EasyThumbnailCache.h"
+#include "EasyThumbnailDrawing.h"
+#include "EasyThumbnailRegistry.h"
+#include "EasyThumbnailRenderer.h"
+#include "HiddenClasses.h"
+
+#include <CanvasTypes.h>
+#include <Components/ActorComponent.h>
+#include <Components/StaticMeshComponent.h>
+#include <Dom/JsonObject.h>
+#include <Engine/Texture2D.h>
+#include <Framework/Application/SlateApplication.h>
+#include <IDetailsView.h>
+#include <IImageWrapper.h>
+#include <IImageWrapperModule.h>
+#include <Materials/Material.h>
+#include <Materials/MaterialInstanceConstant.h>
+#include <Misc/EngineVersion.h>
+#include <Modules/ModuleManager.h>
+#include <PropertyEditorModule.h>
+#include <Serialization/JsonSerializer.h>
+#include <Slate/SlateBrushAsset.h>
+#include <UObject/StrongObjectPtr.h>
+#include <UObject/UObjectIterator.h>
+
+
+namespace EditorMiscUtilitiesBenchmark
+{
+	/** Nearest-rank percentile of sorted samples */
+	static double Percentile(const TArray<double>& Sorted, double Fraction)
+	{
+		const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num()) - 1;
+		return Sorted[FMath::Clamp(Rank, 0, Sorted.Num() - 1)];
+	}
+
+	/** Setup and Teardown run around every sample and are not timed. First run is a warm up */
+	static void Measure(TArray<FResult>& Results, const FString& Name, int32 WorkItems, int32 Iterations, TFunctionRef<void()> Setup, TFunctionRef<void()> Body, TFunctionRef<void()> Teardown)
+	{
+		FResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = Name;
+		Result.WorkItems = WorkItems;
+		Result.SamplesMs.Reserve(Iterations);
+
+		for (int32 Iteration = -1; Iteration < Iterations; Iteration++)
+		{
+			Setup();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Body();
+			const uint64 EndCycles = FPlatformTime::Cycles64();
+			Teardown();
+
+			if (Iteration >= 0)
+			{
+				Result.SamplesMs.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles));
+			}
+		}
+
+		Result.SamplesMs.Sort();
+		UE_LOG(LogEditorMiscUtilities, Display, TEXT("Benchmark %-32s %6d items  median %8.3f ms  p90 %8.3f ms  p99 %8.3f ms"),
+			*Name, WorkItems, Percentile(Result.SamplesMs, 0.5), Percentile(Result.SamplesMs, 0.9), Percentile(Result.SamplesMs, 0.99));
+	}
+
+	static TSharedRef<FJsonObject> ToJson(const FResult& Result)
+	{
+		double Sum = 0.0;
+		for (double Sample : Result.SamplesMs)
+		{
+			Sum += Sample;
+		}
+
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetStringField(TEXT("Name"), Result.Name);
+		Json->SetNumberField(TEXT("WorkItems"), Result.WorkItems);
+		Json->SetNumberField(TEXT("Samples"), Result.SamplesMs.Num());
+		Json->SetNumberField(TEXT("MinMs"), Result.SamplesMs[0]);
+		Json->SetNumberField(TEXT("MedianMs"), Percentile(Result.SamplesMs, 0.5));
+		Json->SetNumberField(TEXT("P90Ms"), Percentile(Result.SamplesMs, 0.9));
+		Json->SetNumberField(TEXT("P99Ms"), Percentile(Result.SamplesMs, 0.99));
+		Json->SetNumberField(TEXT("MaxMs"), Result.SamplesMs.Last());
+		Json->SetNumberField(TEXT("MeanMs"), Sum / Result.SamplesMs.Num());
+		return Json;
+	}
+
+	static TArray<UClass*> GatherClasses(int32 MaxCount, TFunctionRef<bool(UClass*)> Predicate)
+	{
+		TArray<UClass*> Classes;
+		for (TObjectIterator<UClass> It; It && Classes.Num() < MaxCount; ++It)
+		{
+			if (Predicate(*It))
+			{
+				Classes.Add(*It);
+			}
+		}
+		return Classes;
+	}
+}
+
+void EditorMiscUtilitiesBenchmark::RunAll(int32 Iterations, TArray<FResult>& OutResults)
+{
+	const auto NoOp = []() {};
+
+	// Thumbnail classes that are not loaded yet, the common case at editor startup
+	{
+		const int32 NumClasses = 500;
+
+		TMap<FSoftClassPath, FAssetThumbnailSettings> AssetThumbnails;
+		for (int32 Index = 0; Index < NumClasses; Index++)
+		{
+			FAssetThumbnailSettings Settings;
+			Settings.PropertyOrFunction = TEXT("Thumbnail");
+			AssetThumbnails.Add(FSoftClassPath(FString::Printf(TEXT("/Game/EditorMiscUtilitiesBenchmark/Synthetic_%d.Synthetic_%d_C"), Index, Index)), Settings);
+		}
+
+		FEasyThumbnailRegistry& Registry = FEasyThumbnailRegistry::Get();
+		Registry.Shutdown();
+
+		Measure(OutResults, TEXT("ThumbnailRegistry.Register"), NumClasses, Iterations,
+			NoOp,
+			[&]()
+			{
+				Registry.Initialize(AssetThumbnails);
+				Registry.ResolvePending();
+			},
+			[&]() { Registry.Shutdown(); });
+
+		Registry.Initialize(GetDefault<UEditorMiscUtilities>()->AssetThumbnails);
+	}
+
+	// Brush resolution through registry and brush property, then box brush geometry, per drawn thumbnail.
+	// Transient brush assets stand in for project assets, their class is registered for the duration of the case
+	{
+		const int32 NumObjects = 1000;
+		const int32 NumThumbnails = 10000;
+
+		TArray<TStrongObjectPtr<USlateBrushAsset>> BrushAssets;
+		for (int32 Index = 0; Index < NumObjects; Index++)
+		{
+			USlateBrushAsset* BrushAsset = NewObject<USlateBrushAsset>(GetTransientPackage());
+			BrushAsset->Brush.DrawAs = ESlateBrushDrawType::Box;
+			BrushAsset->Brush.ImageSize = FVector2D(64, 64);
+			BrushAsset->Brush.Margin = FMargin(0.05f + 0.4f * (Index % 8) / 8.0f);
+			BrushAssets.Emplace(BrushAsset);
+		}
+
+		TMap<FSoftClassPath, FAssetThumbnailSettings> BrushAssetThumbnails;
+		BrushAssetThumbnails.Add(FSoftClassPath(USlateBrushAsset::StaticClass())).PropertyOrFunction = GET_MEMBER_NAME_CHECKED(USlateBrushAsset, Brush);
+
+		FEasyThumbnailRegistry& Registry = FEasyThumbnailRegistry::Get();
+		Registry.Shutdown();
+		Registry.Initialize(BrushAssetThumbnails);
+
+		TStrongObjectPtr<UEasyThumbnailRenderer> Renderer(NewObject<UEasyThumbnailRenderer>(GetTransientPackage()));
+		TArray<FCanvasUVTri> Triangles;
+		Triangles.Reserve(9 * 2);
+
+		int32 NumResolved = 0;
+		Measure(OutResults, TEXT("Thumbnail.ResolveAndNineSlice"), NumThumbnails, Iterations,
+			[&]() { NumResolved = 0; },
+			[&]()
+			{
+				for (int32 Index = 0; Index < NumThumbnails; Index++)
+				{
+					FSlateBrush Brush;
+					if (Renderer->ResolveBrush(BrushAssets[Index % NumObjects].Get(), Brush))
+					{
+						Triangles.Reset();
+						EasyThumbnail::BuildNineSlice(Triangles, FVector2D::ZeroVector, FVector2D(256, 256), Brush.ImageSize, Brush.Margin, Brush.TintColor.GetSpecifiedColor());
+						NumResolved++;
+					}
+				}
+			},
+			NoOp);
+
+		if (NumResolved != NumThumbnails)
+		{
+			UE_LOG(LogEditorMiscUtilities, Warning, TEXT("Benchmark: Thumbnail.ResolveAndNineSlice resolved %d of %d brushes"), NumResolved, NumThumbnails);
+		}
+
+		Registry.Shutdown();
+		Registry.Initialize(GetDefault<UEditorMiscUtilities>()->AssetThumbnails);
+	}
+
+	// Disk cache key built on every draw, and decode of a stored image on a cache hit.
+	// Decoding runs on the thread pool in editor, it is timed on one thread here to show the cost kept off the game thread
+	{
+		const int32 NumKeys = 10000;
+		const int32 NumImages = 100;
+		const int32 ImageSize = 256;
+
+		TStrongObjectPtr<UTexture2D> Texture(UTexture2D::CreateTransient(64, 64));
+		FSlateBrush Brush;
+		Brush.DrawAs = ESlateBrushDrawType::Box;
+		Brush.SetResourceObject(Texture.Get());
+		const FAssetThumbnailSettings Settings;
+
+		Measure(OutResults, TEXT("ThumbnailCache.MakeKey"), NumKeys, Iterations,
+			NoOp,
+			[&]()
+			{
+				for (int32 Index = 0; Index < NumKeys; Index++)
+				{
+					Brush.Margin = FMargin((Index % 16) / 32.0f);
+					FEasyThumbnailCache::MakeKey(Brush, Settings, ImageSize, ImageSize);
+				}
+			},
+			NoOp);
+
+		// Same format the cache writes
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(ImageSize * ImageSize);
+		for (int32 Index = 0; Index < Pixels.Num(); Index++)
+		{
+			Pixels[Index] = FColor(Index % ImageSize, Index / ImageSize, (Index * 7) % 255, 255);
+		}
+		TSharedPtr<IImageWrapper> Writer = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		Writer->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), ImageSize, ImageSize, ERGBFormat::BGRA, 8);
+		const TArray64<uint8> Compressed = Writer->GetCompressed();
+
+		Measure(OutResults, TEXT("ThumbnailCache.Decode"), NumImages, Iterations,
+			NoOp,
+			[&]()
+			{
+				for (int32 Index = 0; Index < NumImages; Index++)
+				{
+					TArray64<uint8> BGRA;
+					TSharedPtr<IImageWrapper> Reader = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+					Reader->SetCompressed(Compressed.GetData(), Compressed.Num());
+					Reader->GetRaw(ERGBFormat::BGRA, 8, BGRA);
+				}
+			},
+			NoOp);
+	}
+
+	// Material hash computed for the cache key on every draw of a material brush, instances have a texture and a scalar parameter
+	{
+		const int32 NumMaterials = 64;
+		const int32 NumLookups = 10000;
+
+		TStrongObjectPtr<UTexture2D> Texture(UTexture2D::CreateTransient(4, 4));
+		TArray<TStrongObjectPtr<UMaterialInstanceConstant>> Materials;
+		for (int32 Index = 0; Index < NumMaterials; Index++)
+		{
+			UMaterialInstanceConstant* Instance = NewObject<UMaterialInstanceConstant>(GetTransientPackage());
+			Instance->Parent = UMaterial::GetDefaultMaterial(MD_Surface);
+
+			FScalarParameterValue& Parameter = Instance->ScalarParameterValues.AddDefaulted_GetRef();
+			Parameter.ParameterInfo.Name = TEXT("Synthetic");
+			Parameter.ParameterValue = Index;
+
+			FTextureParameterValue& TextureParameter = Instance->TextureParameterValues.AddDefaulted_GetRef();
+			TextureParameter.ParameterInfo.Name = TEXT("SyntheticTexture");
+			TextureParameter.ParameterValue = Texture.Get();
+			Materials.Emplace(Instance);
+		}
+
+		uint32 Combined = 0;
+		Measure(OutResults, TEXT("Thumbnail.MaterialHash"), NumLookups, Iterations,
+			NoOp,
+			[&]()
+			{
+				for (int32 Index = 0; Index < NumLookups; Index++)
+				{
+					Combined ^= FEasyThumbnailCache::HashMaterial(Materials[Index % NumMaterials].Get());
+				}
+			},
+			NoOp);
+
+		UE_LOG(LogEditorMiscUtilities, Verbose, TEXT("Benchmark: Material hash %08x"), Combined);
+	}
+
+	// Tag options and menu grouping, 50 tags on each of 200 component classes
+	{
+		const int32 NumClasses = 200;
+		const int32 NumTagsPerClass = 50;
+
+		TStrongObjectPtr<UEditorMiscUtilities> Settings(NewObject<UEditorMiscUtilities>(GetTransientPackage()));
+		const TArray<UClass*> ComponentClasses = GatherClasses(NumClasses, [](UClass* Class) { return Class->IsChildOf(UActorComponent::StaticClass()); });
+		for (int32 ClassIndex = 0; ClassIndex < ComponentClasses.Num(); ClassIndex++)
+		{
+			FActorComponentComponentTagOptions& Options = Settings->ActorComponentTags.Add(ComponentClasses[ClassIndex]);
+			for (int32 TagIndex = 0; TagIndex < NumTagsPerClass; TagIndex++)
+			{
+				Options.ComponentTags.Add(*FString::Printf(TEXT("Tag_%d_%d"), ClassIndex, TagIndex), FString::Printf(TEXT("Synthetic tag %d of class %d"), TagIndex, ClassIndex));
+			}
+		}
+
+		Measure(OutResults, TEXT("TagMenu.Build"), ComponentClasses.Num() * NumTagsPerClass, Iterations,
+			[&]() { Settings->InvalidateActorComponentTagOptions(); },
+			[&]()
+			{
+				// Null component class accepts every configured class
+				FActorComponentTagsCustomization::BuildTagMenuData(Settings->GetActorComponentTagOptions(nullptr, nullptr));
+			},
+			NoOp);
+	}
+
+	// Details panel rebuild for tagged components, with tag picker customization off and on
+	if (FSlateApplication::IsInitialized())
+	{
+		const int32 NumComponents = 50;
+		const int32 NumTagsPerComponent = 20;
+
+		TArray<TStrongObjectPtr<UStaticMeshComponent>> Components;
+		TArray<TWeakObjectPtr<UObject>> Objects;
+		for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ComponentIndex++)
+		{
+			UStaticMeshComponent* Component = NewObject<UStaticMeshComponent>(GetTransientPackage());
+			for (int32 TagIndex = 0; TagIndex < NumTagsPerComponent; TagIndex++)
+			{
+				Component->ComponentTags.Add(*FString::Printf(TEXT("Tag_%d"), TagIndex));
+			}
+			Components.Emplace(Component);
+			Objects.Add(Component);
+		}
+
+		FDetailsViewArgs DetailsViewArgs;
+		DetailsViewArgs.NameAreaSettings = FDetailsViewArgs::HideNameArea;
+		DetailsViewArgs.bHideSelectionTip = true;
+		TSharedRef<IDetailsView> DetailsView = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor").CreateDetailView(DetailsViewArgs);
+
+		// Goes through settings so the module registers and unregisters customization as in editor
+		UEditorMiscUtilities* Settings = GetMutableDefault<UEditorMiscUtilities>();
+		const bool bWasEnabled = Settings->bShowActorComponentTagPicker;
+		auto SetTagPickerEnabled = [Settings](bool bEnabled)
+		{
+			Settings->bShowActorComponentTagPicker = bEnabled;
+			FPropertyChangedEvent Event(FindFProperty<FProperty>(UEditorMiscUtilities::StaticClass(), GET_MEMBER_NAME_CHECKED(UEditorMiscUtilities, bShowActorComponentTagPicker)));
+			Settings->OnSettingChanged().Broadcast(Settings, Event);
+		};
+
+		for (const bool bEnabled : { false, true })
+		{
+			SetTagPickerEnabled(bEnabled);
+			Measure(OutResults, bEnabled ? TEXT("Details.Rebuild.TagPicker") : TEXT("Details.Rebuild.Default"), NumComponents, Iterations,
+				NoOp,
+				[&]() { DetailsView->SetObjects(Objects, true); },
+				[&]() { DetailsView->SetObjects(TArray<TWeakObjectPtr<UObject>>(), true); });
+		}
+
+		SetTagPickerEnabled(bWasEnabled);
+	}
+	else
+	{
+		UE_LOG(LogEditorMiscUtilities, Display, TEXT("Benchmark: Details.Rebuild skipped, Slate is not initialized. Run with -AllowCommandletRendering"));
+	}
+
+	// Hiding classes that are in memory. Flags are restored after every sample
+	{
+		const int32 NumClasses = 1000;
+
+		const TArray<UClass*> Classes = GatherClasses(NumClasses, [](UClass* Class) { return !Class->HasAnyClassFlags(CLASS_Hidden); });
+		TArray<FSoftClassPath> HideClasses;
+		for (UClass* Class : Classes)
+		{
+			HideClasses.Add(FSoftClassPath(Class));
+		}
+
+		FHiddenClasses HiddenClasses;
+		Measure(OutResults, TEXT("HideClasses.Apply"), Classes.Num(), Iterations,
+			NoOp,
+			[&]()
+			{
+				HiddenClasses.Initialize(HideClasses);
+				HiddenClasses.ProcessAll();
+			},
+			[&]()
+			{
+				HiddenClasses.Shutdown();
+				for (UClass* Class : Classes)
+				{
+					EnumRemoveFlags(Class->ClassFlags, CLASS_Hidden);
+				}
+			});
+	}
+}
+
+FString EditorMiscUtilitiesBenchmark::ToJsonString(const TArray<FResult>& Results, int32 Iterations)
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Root->SetNumberField(TEXT("Iterations"), Iterations);
+
+	TArray<TSharedPtr<FJsonValue>> Benchmarks;
+	for (const FResult& Result : Results)
+	{
+		Benchmarks.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+	}
+	Root->SetArrayField(TEXT("Benchmarks"), Benchmarks);
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Output;
+}
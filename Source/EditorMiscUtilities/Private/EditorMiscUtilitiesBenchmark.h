@@ -0,0 +1,24 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Timings of plugin hot paths on synthetic data, shared by the benchmark commandlet and automation tests */
+namespace EditorMiscUtilitiesBenchmark
+{
+	struct FResult
+	{
+		FString Name;
+		int32 WorkItems = 0;
+
+		/** Sorted */
+		TArray<double> SamplesMs;
+	};
+
+	/** Run every case. Details panel cases need Slate and are skipped without it */
+	void RunAll(int32 Iterations, TArray<FResult>& OutResults);
+
+	/** Median and percentiles of each result, with engine version and platform */
+	FString ToJsonString(const TArray<FResult>& Results, int32 Iterations);
+}
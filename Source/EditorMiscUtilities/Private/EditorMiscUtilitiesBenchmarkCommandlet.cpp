@@ -0,0 +1,42 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EditorMiscUtilitiesBenchmarkCommandlet.h"
+#include "EditorMiscUtilitiesBenchmark.h"
+#include "EditorMiscUtilitiesModule.h"
+
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+
+UEditorMiscUtilitiesBenchmarkCommandlet::UEditorMiscUtilitiesBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UEditorMiscUtilitiesBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace EditorMiscUtilitiesBenchmark;
+
+	int32 Iterations = 20;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("EditorMiscUtilities") / TEXT("Benchmark.json");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<FResult> Results;
+	RunAll(Iterations, Results);
+
+	const FString Output = ToJsonString(Results, Iterations);
+	if (!FFileHelper::SaveStringToFile(Output, *OutputPath))
+	{
+		UE_LOG(LogEditorMiscUtilities, Error, TEXT("Benchmark: Failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogEditorMiscUtilities, Display, TEXT("Benchmark: Results written to %s"), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,28 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EditorMiscUtilitiesBenchmarkCommandlet.generated.h"
+
+
+/**
+ * Repeatable timings of plugin hot paths on synthetic data, written as JSON with median and percentiles.
+ * Runs headless, e.g. with -nullrhi -unattended. Details panel cases need Slate and run only with -AllowCommandletRendering.
+ * The same cases run as the EditorMiscUtilities.Benchmark automation test
+ *
+ * Usage: -run=EditorMiscUtilitiesBenchmark [-Iterations=20] [-Output=Path/To/Result.json]
+ */
+UCLASS()
+class UEditorMiscUtilitiesBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEditorMiscUtilitiesBenchmarkCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
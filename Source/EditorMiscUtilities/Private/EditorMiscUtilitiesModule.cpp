@@ -2,12 +2,19 @@
 
 #include "EditorMiscUtilitiesModule.h"
 #include "Modules/ModuleManager.h"
+#include <Components/ActorComponent.h>
 
 #include "EditorMiscUtilitiesSettings.h"
 #include "MapPickerMenu.h"
-#include "EasyThumbnailRenderer.h"
+#include "EasyThumbnailRegistry.h"
+#include "EasyThumbnailAtlas.h"
+#include "EasyThumbnailCache.h"
+#include "EasyThumbnailScheduler.h"
 #include "ComponentTagCustomization.h"
 #include "CustomizationBinder.h"
+#include "HiddenClasses.h"
+#include "ComponentTagUsageIndex.h"
+#include "WorldAssetIndex.h"
 
 
 DEFINE_LOG_CATEGORY(LogEditorMiscUtilities);
@@ -31,79 +38,113 @@ public:
 		const UEditorMiscUtilities* Settings = GetDefault<UEditorMiscUtilities>();
 
 
-		FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
-		{
-			if (Settings->bShowActorComponentTagPicker)
-			{
-				Binder.RegisterProperty(PropertyModule, "ArrayProperty", 
-					FOnGetPropertyTypeCustomizationInstance::CreateStatic(&FActorComponentTagsCustomization::MakeInstance), 
-					MakeShared<FActorComponentTagsCustomization::FPropertyTypeIdentifier>());
-			}
-		}
-		
+		SetTagPickerEnabled(Settings->bShowActorComponentTagPicker);
 
 		CommonMaps = FMapPickerMenu::Create(TEXT("CommonMapOptions"), FMapPicker_GetMaps::CreateStatic(&FEditorMiscUtilitiesModule::GetCommonMaps));
+		if (CommonMaps.IsValid())
+		{
+			CommonMaps->SetPrefetchEnabled(TAttribute<bool>::CreateLambda([]() { return GetDefault<UEditorMiscUtilities>()->bPrefetchCommonMaps; }));
+			CommonMaps->SetListAllMaps(Settings->bListAllMapsInPicker);
+		}
 
 
-		UThumbnailManager& ThumbnailManager = UThumbnailManager::Get();
-		for (const TPair<FSoftClassPath, FAssetThumbnailSettings>& Thumbnail : Settings->AssetThumbnails)
+		SettingsChangedHandle = GetMutableDefault<UEditorMiscUtilities>()->OnSettingChanged().AddLambda([this](UObject*, FPropertyChangedEvent& Event)
 		{
-			if (UEasyThumbnailRenderer::TryRegisterForClass(ThumbnailManager, Thumbnail.Key, Thumbnail.Value))
+			const FName PropertyName = Event.GetMemberPropertyName();
+			if (PropertyName == GET_MEMBER_NAME_CHECKED(UEditorMiscUtilities, ThumbnailFrameBudgetMs))
 			{
-				RegisteredThumbnails.Add(Thumbnail.Key.ResolveClass());
-			}						
-		}
+				FEasyThumbnailScheduler::Get().SetFrameBudget(GetDefault<UEditorMiscUtilities>()->ThumbnailFrameBudgetMs / 1000.0f);
+			}
+			else if (PropertyName == GET_MEMBER_NAME_CHECKED(UEditorMiscUtilities, bShowActorComponentTagPicker))
+			{
+				SetTagPickerEnabled(GetDefault<UEditorMiscUtilities>()->bShowActorComponentTagPicker);
+			}
+
+			if (!CommonMaps.IsValid())
+			{
+				return;
+			}
+
+			if (PropertyName == GET_MEMBER_NAME_CHECKED(UEditorMiscUtilities, CommonEditorMaps))
+			{
+				CommonMaps->RefreshMaps();
+			}
+			else if (PropertyName == GET_MEMBER_NAME_CHECKED(UEditorMiscUtilities, bListAllMapsInPicker))
+			{
+				CommonMaps->SetListAllMaps(GetDefault<UEditorMiscUtilities>()->bListAllMapsInPicker);
+			}
+		});
+
+
+		FEasyThumbnailRegistry::Get().Initialize(Settings->AssetThumbnails);
+		FEasyThumbnailScheduler::Get().SetFrameBudget(Settings->ThumbnailFrameBudgetMs / 1000.0f);
   
   
-		FCoreDelegates::OnFEngineLoopInitComplete.AddLambda([]()
+		EngineLoopInitCompleteHandle = FCoreDelegates::OnFEngineLoopInitComplete.AddLambda([this]()
 		{
-			TArray<FSoftClassPath> HideClasses = GetDefault<UEditorMiscUtilities>()->HideClasses;
-
-			for (const FSoftClassPath& ClassPath : HideClasses)
-			{	
-				if (!ClassPath.IsValid())
-				{
-					continue;
-				}
-
-				UClass* Class = ClassPath.ResolveClass();
-				if (Class == nullptr)
-				{
-					Class = ClassPath.TryLoadClass<UClass>();
-				}
-				if (Class)
-				{
-					EnumAddFlags(Class->ClassFlags, CLASS_Hidden);
-				}
-			}
+			HiddenClasses.Initialize(GetDefault<UEditorMiscUtilities>()->HideClasses);
 		});  
   
 	}
 
     virtual void ShutdownModule() override
     {	
-		if (UThumbnailManager* ThumbnailManager = UThumbnailManager::TryGet())
+		FEasyThumbnailRegistry::Get().Shutdown();
+		FEasyThumbnailAtlas::Get().Reset();
+		FEasyThumbnailCache::Get().Reset();
+		FEasyThumbnailScheduler::Get().Reset();
+		FComponentTagUsageIndex::Get().Shutdown();
+
+		FCoreDelegates::OnFEngineLoopInitComplete.Remove(EngineLoopInitCompleteHandle);
+		HiddenClasses.Shutdown();
+		if (UObjectInitialized())
 		{
-			for (TWeakObjectPtr<UClass>& WeakAssetClass : RegisteredThumbnails)
-			{
-				if (UClass* AssetClass = WeakAssetClass.Get())
-				{
-					ThumbnailManager->UnregisterCustomRenderer(AssetClass);
-				}				
-			}
-		}	
-		RegisteredThumbnails.Empty();
+			GetMutableDefault<UEditorMiscUtilities>()->OnSettingChanged().Remove(SettingsChangedHandle);
+		}
 		CommonMaps.Reset();
+		FWorldAssetIndex::Get().Shutdown();
 
 		Binder.UnregisterAll();
+		TagPickerIdentifier.Reset();
     }
 
+private:
+	/** Customize only UActorComponent::ComponentTags. Identifier is a pointer compare per array row */
+	void SetTagPickerEnabled(bool bEnabled)
+	{
+		if (bEnabled == TagPickerIdentifier.IsValid())
+		{
+			return;
+		}
+
+		if (!bEnabled)
+		{
+			Binder.UnregisterProperty("ArrayProperty", TagPickerIdentifier);
+			TagPickerIdentifier.Reset();
+			return;
+		}
+
+		TagPickerIdentifier = MakeShared<FCustomizationBinder::FPropertyNameIdentifier>(UActorComponent::StaticClass(), GET_MEMBER_NAME_CHECKED(UActorComponent, ComponentTags));
+		Binder.RegisterProperty("ArrayProperty",
+			FOnGetPropertyTypeCustomizationInstance::CreateStatic(&FActorComponentTagsCustomization::MakeInstance),
+			TagPickerIdentifier);
+
+		// Tag options follow usage counts through the index version, nothing to subscribe to
+		if (GetDefault<UEditorMiscUtilities>()->NumFrequentlyUsedTags > 0)
+		{
+			FComponentTagUsageIndex::Get().Initialize();
+		}
+	}
+
 private:
 	FCustomizationBinder Binder;
+	TSharedPtr<FCustomizationBinder::FPropertyNameIdentifier> TagPickerIdentifier;
 
 	TSharedPtr<FMapPickerMenu> CommonMaps;
+	FDelegateHandle SettingsChangedHandle;
 
-	TArray<TWeakObjectPtr<UClass>> RegisteredThumbnails;
+	FHiddenClasses HiddenClasses;
+	FDelegateHandle EngineLoopInitCompleteHandle;
 };
 
 
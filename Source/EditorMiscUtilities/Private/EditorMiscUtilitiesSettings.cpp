@@ -2,6 +2,10 @@
 
 
 #include "EditorMiscUtilitiesSettings.h"
+#include "ComponentTagUsageIndex.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <Editor.h>
 
 
 TArray<FActorComponentTagOptionInfo> UEditorMiscUtilities::GetCommonActorComponentTagOptions(const UClass* ActorClass, const UClass* ComponentClass) const
@@ -11,16 +15,84 @@ TArray<FActorComponentTagOptionInfo> UEditorMiscUtilities::GetCommonActorCompone
 		return GetActorComponentTagOptionsOverride.Execute(ActorClass, ComponentClass);
 	}
 
+	return *GetActorComponentTagOptions(ActorClass, ComponentClass);
+}
+
+TSharedRef<const TArray<FActorComponentTagOptionInfo>> UEditorMiscUtilities::GetActorComponentTagOptions(const UClass* ActorClass, const UClass* ComponentClass) const
+{
+	EDITORMISCUTILITIES_SCOPE(TagOptions);
+
+	if (GetActorComponentTagOptionsOverride.IsBound())
+	{
+		TArray<FActorComponentTagOptionInfo> Options = GetActorComponentTagOptionsOverride.Execute(ActorClass, ComponentClass);
+
+		// Override result is not cached, but is normalized the same way
+		Options.StableSort([](const FActorComponentTagOptionInfo& A, const FActorComponentTagOptionInfo& B) { return A.Category < B.Category; });
+		return MakeShared<TArray<FActorComponentTagOptionInfo>>(MoveTemp(Options));
+	}
+
+	const uint32 UsageVersion = FComponentTagUsageIndex::Get().GetVersion();
+	if (FActorComponentTagOptionsEntry* Cached = ActorComponentTagIndex.Find(ComponentClass))
+	{
+		// Usage changes only move frequently used tags, configured options are kept
+		if (Cached->UsageVersion != UsageVersion)
+		{
+			Cached->UsageVersion = UsageVersion;
+
+			TArray<TPair<FName, int32>> MostUsed;
+			GetFrequentlyUsedTags(ComponentClass, MostUsed);
+			if (MostUsed != Cached->MostUsed)
+			{
+				Cached->Options = AddFrequentlyUsedTags(Cached->Configured, MostUsed);
+				Cached->MostUsed = MoveTemp(MostUsed);
+			}
+		}
+		return Cached->Options;
+	}
+
+	// Recompiled blueprint may change hierarchy
+	if (!BlueprintCompiledHandle.IsValid() && GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddUObject(const_cast<UEditorMiscUtilities*>(this), &UEditorMiscUtilities::InvalidateActorComponentTagOptions);
+	}
+
+	TSharedRef<const TArray<FActorComponentTagOptionInfo>> Configured = BuildActorComponentTagOptions(ComponentClass);
+	TArray<TPair<FName, int32>> MostUsed;
+	GetFrequentlyUsedTags(ComponentClass, MostUsed);
+
+	FActorComponentTagOptionsEntry Entry{ Configured, AddFrequentlyUsedTags(Configured, MostUsed), MoveTemp(MostUsed), UsageVersion };
+	return ActorComponentTagIndex.Add(ComponentClass, MoveTemp(Entry)).Options;
+}
+
+TSharedRef<const TArray<FActorComponentTagOptionInfo>> UEditorMiscUtilities::BuildActorComponentTagOptions(const UClass* ComponentClass) const
+{
+	// Filters are matched by path, so a filter class that is not loaded yet is not mistaken for a mismatch and cached
+	TSet<FSoftObjectPath> ComponentClassHierarchy;
+	for (const UClass* Class = ComponentClass; Class; Class = Class->GetSuperClass())
+	{
+		ComponentClassHierarchy.Add(FSoftObjectPath(Class));
+	}
+
 	TArray<FActorComponentTagOptionInfo> Options;
 	for (const auto& Pair : ActorComponentTags)
 	{
 		const TSoftClassPtr<UActorComponent>& ClassFilter = Pair.Key;
 		const FActorComponentComponentTagOptions& TagOptions = Pair.Value;
 
-		const UClass* ResolvedClass = ClassFilter.Get();
-		if (ClassFilter.IsNull() || !ComponentClass || ComponentClass->IsChildOf(ResolvedClass))
-		{	
-			FString Category = ResolvedClass ? ResolvedClass->GetDisplayNameText().ToString() : TEXT("");
+		if (ClassFilter.IsNull() || !ComponentClass || ComponentClassHierarchy.Contains(ClassFilter.ToSoftObjectPath()))
+		{
+			FString Category;
+			if (const UClass* ResolvedClass = ClassFilter.Get())
+			{
+				Category = ResolvedClass->GetDisplayNameText().ToString();
+			}
+			else if (!ClassFilter.IsNull())
+			{
+				// Same name the class would display once loaded, without the blueprint suffix
+				FString ClassName = ClassFilter.GetAssetName();
+				ClassName.RemoveFromEnd(TEXT("_C"));
+				Category = FName::NameToDisplayString(ClassName, false);
+			}
 
 			for (const auto& TagInfo : TagOptions.ComponentTags)
 			{
@@ -29,5 +101,82 @@ TArray<FActorComponentTagOptionInfo> UEditorMiscUtilities::GetCommonActorCompone
 		}
 	}
 
-	return Options;
+	// Categories in order, config order within category
+	Options.StableSort([](const FActorComponentTagOptionInfo& A, const FActorComponentTagOptionInfo& B) { return A.Category < B.Category; });
+
+	TSet<TPair<FString, FName>> Unique;
+	Unique.Reserve(Options.Num());
+	Options.RemoveAll([&Unique](const FActorComponentTagOptionInfo& Option)
+	{
+		bool bAlreadyInSet = false;
+		Unique.Add(TPair<FString, FName>(Option.Category, Option.Name), &bAlreadyInSet);
+		return bAlreadyInSet;
+	});
+
+	return MakeShared<TArray<FActorComponentTagOptionInfo>>(MoveTemp(Options));
+}
+
+void UEditorMiscUtilities::GetFrequentlyUsedTags(const UClass* ComponentClass, TArray<TPair<FName, int32>>& OutTags) const
+{
+	OutTags.Reset();
+
+	const FComponentTagUsageIndex& UsageIndex = FComponentTagUsageIndex::Get();
+	if (NumFrequentlyUsedTags > 0 && ComponentClass && UsageIndex.IsReady())
+	{
+		UsageIndex.GetMostUsedTags(ComponentClass, NumFrequentlyUsedTags, OutTags);
+	}
+}
+
+TSharedRef<const TArray<FActorComponentTagOptionInfo>> UEditorMiscUtilities::AddFrequentlyUsedTags(const TSharedRef<const TArray<FActorComponentTagOptionInfo>>& Configured, const TArray<TPair<FName, int32>>& MostUsed)
+{
+	if (MostUsed.Num() == 0)
+	{
+		return Configured;
+	}
+
+	// Most used tags go first, described by config when available
+	TArray<FActorComponentTagOptionInfo> Options;
+	Options.Reserve(MostUsed.Num() + Configured->Num());
+	for (const TPair<FName, int32>& Pair : MostUsed)
+	{
+		const FActorComponentTagOptionInfo* ConfiguredOption = Configured->FindByPredicate([&Pair](const FActorComponentTagOptionInfo& Option) { return Option.Name == Pair.Key; });
+		const FString Description = ConfiguredOption && !ConfiguredOption->Description.IsEmpty() ? ConfiguredOption->Description : FString::Printf(TEXT("Used %d times"), Pair.Value);
+		Options.Add(FActorComponentTagOptionInfo(Pair.Key, TEXT("Frequently Used"), Description));
+	}
+	Options.Append(*Configured);
+
+	return MakeShared<TArray<FActorComponentTagOptionInfo>>(MoveTemp(Options));
+}
+
+void UEditorMiscUtilities::InvalidateActorComponentTagOptions()
+{
+	ActorComponentTagIndex.Empty();
+}
+
+void UEditorMiscUtilities::BeginDestroy()
+{
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+	BlueprintCompiledHandle.Reset();
+	ActorComponentTagIndex.Empty();
+
+	Super::BeginDestroy();
+}
+
+void UEditorMiscUtilities::PostReloadConfig(FProperty* PropertyThatWasLoaded)
+{
+	Super::PostReloadConfig(PropertyThatWasLoaded);
+
+	InvalidateActorComponentTagOptions();
+}
+
+#if WITH_EDITOR
+void UEditorMiscUtilities::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	InvalidateActorComponentTagOptions();
 }
+#endif
@@ -0,0 +1,140 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EditorMiscUtilitiesStats.h"
+
+#include <HAL/IConsoleManager.h>
+#include <atomic>
+
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailDraw);
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailRegistry);
+DEFINE_STAT(STAT_EditorMiscUtilities_HideClasses);
+DEFINE_STAT(STAT_EditorMiscUtilities_TagOptions);
+DEFINE_STAT(STAT_EditorMiscUtilities_TagMenu);
+DEFINE_STAT(STAT_EditorMiscUtilities_TagUsage);
+DEFINE_STAT(STAT_EditorMiscUtilities_MapPicker);
+
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailsDrawn);
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailCacheHits);
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailCacheMisses);
+DEFINE_STAT(STAT_EditorMiscUtilities_ClassesHidden);
+DEFINE_STAT(STAT_EditorMiscUtilities_TagMenuEntries);
+DEFINE_STAT(STAT_EditorMiscUtilities_MapPickerEntries);
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailClassesDeferred);
+
+DEFINE_STAT(STAT_EditorMiscUtilities_ThumbnailRegistryStartup);
+
+
+namespace EditorMiscUtilitiesStats
+{
+	struct FFeatureCost
+	{
+		std::atomic<uint64> Calls{ 0 };
+		std::atomic<uint64> Cycles{ 0 };
+		std::atomic<uint64> MaxCycles{ 0 };
+	};
+
+	static FFeatureCost FeatureCosts[(int32)EEditorMiscUtilitiesFeature::Num];
+	static std::atomic<int64> Counters[(int32)EEditorMiscUtilitiesCounter::Num];
+	static std::atomic<double> StartupTimes[(int32)EEditorMiscUtilitiesStartup::Num];
+
+	static const TCHAR* FeatureNames[] =
+	{
+		TEXT("ThumbnailDraw"),
+		TEXT("ThumbnailRegistry"),
+		TEXT("HideClasses"),
+		TEXT("TagOptions"),
+		TEXT("TagMenu"),
+		TEXT("TagUsage"),
+		TEXT("MapPicker"),
+	};
+	static_assert(UE_ARRAY_COUNT(FeatureNames) == (int32)EEditorMiscUtilitiesFeature::Num, "Feature name missing");
+
+	static const TCHAR* CounterNames[] =
+	{
+		TEXT("ThumbnailsDrawn"),
+		TEXT("ThumbnailCacheHits"),
+		TEXT("ThumbnailCacheMisses"),
+		TEXT("ClassesHidden"),
+		TEXT("TagMenuEntries"),
+		TEXT("MapPickerEntries"),
+		TEXT("ThumbnailClassesDeferred"),
+	};
+	static_assert(UE_ARRAY_COUNT(CounterNames) == (int32)EEditorMiscUtilitiesCounter::Num, "Counter name missing");
+
+	static const TCHAR* StartupNames[] =
+	{
+		TEXT("ThumbnailRegistry"),
+	};
+	static_assert(UE_ARRAY_COUNT(StartupNames) == (int32)EEditorMiscUtilitiesStartup::Num, "Startup step name missing");
+
+	void AddCost(EEditorMiscUtilitiesFeature Feature, uint64 Cycles)
+	{
+		FFeatureCost& Cost = FeatureCosts[(int32)Feature];
+		Cost.Calls++;
+		Cost.Cycles += Cycles;
+
+		uint64 Max = Cost.MaxCycles.load();
+		while (Cycles > Max && !Cost.MaxCycles.compare_exchange_weak(Max, Cycles))
+		{
+		}
+	}
+
+	void AddCount(EEditorMiscUtilitiesCounter Counter, int64 Amount)
+	{
+		Counters[(int32)Counter] += Amount;
+	}
+
+	void SetStartupTime(EEditorMiscUtilitiesStartup Step, double Milliseconds)
+	{
+		StartupTimes[(int32)Step] = Milliseconds;
+	}
+
+	void Dump(FOutputDevice& Ar)
+	{
+		Ar.Logf(TEXT("EditorMiscUtilities cumulative cost:"));
+		Ar.Logf(TEXT("  %-20s %10s %12s %10s %10s"), TEXT("Feature"), TEXT("Calls"), TEXT("Total ms"), TEXT("Avg ms"), TEXT("Max ms"));
+		for (int32 Index = 0; Index < (int32)EEditorMiscUtilitiesFeature::Num; Index++)
+		{
+			const FFeatureCost& Cost = FeatureCosts[Index];
+			const uint64 Calls = Cost.Calls.load();
+			const double TotalMs = FPlatformTime::ToMilliseconds64(Cost.Cycles.load());
+			Ar.Logf(TEXT("  %-20s %10llu %12.2f %10.3f %10.3f"), FeatureNames[Index], Calls, TotalMs, Calls > 0 ? TotalMs / Calls : 0.0, FPlatformTime::ToMilliseconds64(Cost.MaxCycles.load()));
+		}
+
+		Ar.Logf(TEXT("EditorMiscUtilities counters:"));
+		for (int32 Index = 0; Index < (int32)EEditorMiscUtilitiesCounter::Num; Index++)
+		{
+			Ar.Logf(TEXT("  %-20s %10lld"), CounterNames[Index], Counters[Index].load());
+		}
+
+		Ar.Logf(TEXT("EditorMiscUtilities startup:"));
+		for (int32 Index = 0; Index < (int32)EEditorMiscUtilitiesStartup::Num; Index++)
+		{
+			Ar.Logf(TEXT("  %-20s %10.3f ms"), StartupNames[Index], StartupTimes[Index].load());
+		}
+	}
+
+	void Reset()
+	{
+		for (FFeatureCost& Cost : FeatureCosts)
+		{
+			Cost.Calls = 0;
+			Cost.Cycles = 0;
+			Cost.MaxCycles = 0;
+		}
+		for (std::atomic<int64>& Counter : Counters)
+		{
+			Counter = 0;
+		}
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice DumpStatsCommand(
+	TEXT("EditorMiscUtilities.DumpStats"),
+	TEXT("Print time spent in each EditorMiscUtilities feature since startup or last reset"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&EditorMiscUtilitiesStats::Dump));
+
+static FAutoConsoleCommand ResetStatsCommand(
+	TEXT("EditorMiscUtilities.ResetStats"),
+	TEXT("Reset counters printed by EditorMiscUtilities.DumpStats"),
+	FConsoleCommandDelegate::CreateStatic(&EditorMiscUtilitiesStats::Reset));
@@ -0,0 +1,100 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Stats/Stats.h>
+#include <ProfilingDebugging/CpuProfilerTrace.h>
+
+DECLARE_STATS_GROUP(TEXT("EditorMiscUtilities"), STATGROUP_EditorMiscUtilities, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Thumbnail Draw"), STAT_EditorMiscUtilities_ThumbnailDraw, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Thumbnail Registry"), STAT_EditorMiscUtilities_ThumbnailRegistry, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hide Classes"), STAT_EditorMiscUtilities_HideClasses, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tag Options"), STAT_EditorMiscUtilities_TagOptions, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tag Menu"), STAT_EditorMiscUtilities_TagMenu, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tag Usage"), STAT_EditorMiscUtilities_TagUsage, STATGROUP_EditorMiscUtilities, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Map Picker"), STAT_EditorMiscUtilities_MapPicker, STATGROUP_EditorMiscUtilities, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnails Drawn"), STAT_EditorMiscUtilities_ThumbnailsDrawn, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnail Cache Hits"), STAT_EditorMiscUtilities_ThumbnailCacheHits, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnail Cache Misses"), STAT_EditorMiscUtilities_ThumbnailCacheMisses, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Classes Hidden"), STAT_EditorMiscUtilities_ClassesHidden, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tag Menu Entries"), STAT_EditorMiscUtilities_TagMenuEntries, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Map Picker Entries"), STAT_EditorMiscUtilities_MapPickerEntries, STATGROUP_EditorMiscUtilities, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnail Classes Deferred"), STAT_EditorMiscUtilities_ThumbnailClassesDeferred, STATGROUP_EditorMiscUtilities, );
+
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Thumbnail Registry Startup (ms)"), STAT_EditorMiscUtilities_ThumbnailRegistryStartup, STATGROUP_EditorMiscUtilities, );
+
+/** Features whose cost is kept for EditorMiscUtilities.DumpStats, also in builds without stats */
+enum class EEditorMiscUtilitiesFeature : uint8
+{
+	ThumbnailDraw,
+	ThumbnailRegistry,
+	HideClasses,
+	TagOptions,
+	TagMenu,
+	TagUsage,
+	MapPicker,
+	Num
+};
+
+enum class EEditorMiscUtilitiesCounter : uint8
+{
+	ThumbnailsDrawn,
+	ThumbnailCacheHits,
+	ThumbnailCacheMisses,
+	ClassesHidden,
+	TagMenuEntries,
+	MapPickerEntries,
+	ThumbnailClassesDeferred,
+	Num
+};
+
+/** Startup steps whose last duration is kept for EditorMiscUtilities.DumpStats */
+enum class EEditorMiscUtilitiesStartup : uint8
+{
+	ThumbnailRegistry,
+	Num
+};
+
+namespace EditorMiscUtilitiesStats
+{
+	void AddCost(EEditorMiscUtilitiesFeature Feature, uint64 Cycles);
+	void AddCount(EEditorMiscUtilitiesCounter Counter, int64 Amount);
+	void SetStartupTime(EEditorMiscUtilitiesStartup Step, double Milliseconds);
+	void Dump(FOutputDevice& Ar);
+	void Reset();
+}
+
+/** Adds time spent in scope to feature total */
+struct FEditorMiscUtilitiesCostScope
+{
+	FEditorMiscUtilitiesCostScope(EEditorMiscUtilitiesFeature InFeature)
+		: Feature(InFeature)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FEditorMiscUtilitiesCostScope()
+	{
+		EditorMiscUtilitiesStats::AddCost(Feature, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+	EEditorMiscUtilitiesFeature Feature;
+	uint64 StartCycles;
+};
+
+/** Stat cycle counter, Insights trace scope and cumulative cost of a feature */
+#define EDITORMISCUTILITIES_SCOPE(Feature) \
+	SCOPE_CYCLE_COUNTER(STAT_EditorMiscUtilities_##Feature); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(EditorMiscUtilities_##Feature); \
+	FEditorMiscUtilitiesCostScope ANONYMOUS_VARIABLE(EditorMiscUtilitiesCost)(EEditorMiscUtilitiesFeature::Feature)
+
+#define EDITORMISCUTILITIES_COUNT(Counter, Amount) \
+	INC_DWORD_STAT_BY(STAT_EditorMiscUtilities_##Counter, Amount); \
+	EditorMiscUtilitiesStats::AddCount(EEditorMiscUtilitiesCounter::Counter, Amount)
+
+#define EDITORMISCUTILITIES_STARTUP_TIME(Step, Milliseconds) \
+	SET_FLOAT_STAT(STAT_EditorMiscUtilities_##Step##Startup, Milliseconds); \
+	EditorMiscUtilitiesStats::SetStartupTime(EEditorMiscUtilitiesStartup::Step, Milliseconds)
@@ -0,0 +1,158 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "HiddenClasses.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <Engine/Blueprint.h>
+
+/** Game thread time spent hiding classes per tick */
+static const double HiddenClassesTickBudgetSeconds = 0.002;
+
+
+void FHiddenClasses::Initialize(const TArray<FSoftClassPath>& HideClasses)
+{
+	Shutdown();
+
+	PendingClasses.Reserve(HideClasses.Num());
+	for (const FSoftClassPath& ClassPath : HideClasses)
+	{
+		if (ClassPath.IsValid())
+		{
+			PendingClasses.Add(ClassPath.GetAssetPath());
+		}
+	}
+
+	if (PendingClasses.Num() == 0)
+	{
+		return;
+	}
+
+	ScanQueue = PendingClasses.Array();
+	ScanIndex = 0;
+
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FHiddenClasses::OnAssetLoaded);
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FHiddenClasses::OnModulesChanged);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHiddenClasses::Tick));
+}
+
+void FHiddenClasses::Shutdown()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	TickerHandle.Reset();
+	AssetLoadedHandle.Reset();
+	ModulesChangedHandle.Reset();
+
+	PendingClasses.Empty();
+	ScanQueue.Empty();
+	ScanIndex = 0;
+	NumHidden = 0;
+	NumHiddenReported = 0;
+	TimeSpent = 0.0;
+}
+
+void FHiddenClasses::ProcessAll()
+{
+	if (!TickerHandle.IsValid())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	while (Tick(0.0f))
+	{
+	}
+}
+
+bool FHiddenClasses::Tick(float DeltaTime)
+{
+	EDITORMISCUTILITIES_SCOPE(HideClasses);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (ScanIndex < ScanQueue.Num())
+	{
+		const FTopLevelAssetPath& ClassPath = ScanQueue[ScanIndex++];
+		if (PendingClasses.Contains(ClassPath))
+		{
+			TryHide(FindObject<UClass>(ClassPath));
+		}
+
+		if (FPlatformTime::Seconds() - StartTime > HiddenClassesTickBudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	TimeSpent += FPlatformTime::Seconds() - StartTime;
+
+	if (ScanIndex < ScanQueue.Num())
+	{
+		return true;
+	}
+
+	// Every module load rescans, only scans that hid something are worth a line in the log
+	if (NumHidden != NumHiddenReported)
+	{
+		UE_LOG(LogEditorMiscUtilities, Log, TEXT("HideClasses: Hidden %d classes in %.2f ms, %d will be hidden when loaded"), NumHidden, TimeSpent * 1000.0, PendingClasses.Num());
+		NumHiddenReported = NumHidden;
+	}
+	else
+	{
+		UE_LOG(LogEditorMiscUtilities, Verbose, TEXT("HideClasses: Rescan hid nothing, %d will be hidden when loaded"), PendingClasses.Num());
+	}
+
+	ScanQueue.Empty();
+	TickerHandle.Reset();
+	return false;
+}
+
+bool FHiddenClasses::TryHide(UClass* Class)
+{
+	if (Class == nullptr || PendingClasses.Remove(Class->GetClassPathName()) == 0)
+	{
+		return false;
+	}
+
+	EnumAddFlags(Class->ClassFlags, CLASS_Hidden);
+	NumHidden++;
+	EDITORMISCUTILITIES_COUNT(ClassesHidden, 1);
+	return true;
+}
+
+void FHiddenClasses::OnAssetLoaded(UObject* Object)
+{
+	if (PendingClasses.Num() == 0)
+	{
+		return;
+	}
+
+	EDITORMISCUTILITIES_SCOPE(HideClasses);
+
+	UClass* Class = Cast<UClass>(Object);
+	if (Class == nullptr)
+	{
+		if (UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+		{
+			Class = Blueprint->GeneratedClass;
+		}
+	}
+
+	for (; Class; Class = Class->GetSuperClass())
+	{
+		TryHide(Class);
+	}
+}
+
+void FHiddenClasses::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// Native classes of newly loaded module, rescan remaining paths over next ticks
+	if (Reason == EModuleChangeReason::ModuleLoaded && PendingClasses.Num() > 0 && !TickerHandle.IsValid())
+	{
+		ScanQueue = PendingClasses.Array();
+		ScanIndex = 0;
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHiddenClasses::Tick));
+	}
+}
@@ -0,0 +1,47 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Containers/Ticker.h>
+#include <Modules/ModuleManager.h>
+
+/**
+ * Applies UEditorMiscUtilities::HideClasses without loading anything.
+ * Classes in memory are hidden over several ticks, the rest when they load
+ */
+class FHiddenClasses
+{
+public:
+	void Initialize(const TArray<FSoftClassPath>& HideClasses);
+	void Shutdown();
+
+	int32 GetNumPending() const { return PendingClasses.Num(); }
+
+	/** Finish scan of classes in memory right away instead of over ticks */
+	void ProcessAll();
+
+private:
+	bool Tick(float DeltaTime);
+	bool TryHide(UClass* Class);
+
+	void OnAssetLoaded(UObject* Object);
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	/** Classes not hidden yet */
+	TSet<FTopLevelAssetPath> PendingClasses;
+
+	/** Snapshot of PendingClasses walked by Tick */
+	TArray<FTopLevelAssetPath> ScanQueue;
+	int32 ScanIndex = 0;
+
+	int32 NumHidden = 0;
+
+	/** NumHidden when a scan was last logged */
+	int32 NumHiddenReported = 0;
+	double TimeSpent = 0.0;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle ModulesChangedHandle;
+};
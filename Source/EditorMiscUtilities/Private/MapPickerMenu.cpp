@@ -1,16 +1,39 @@
 // Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
 
 #include "MapPickerMenu.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
+#include "SMapPicker.h"
+#include "WorldAssetIndex.h"
 
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <AssetThumbnail.h>
+#include <Async/Async.h>
+#include <Engine/World.h>
+#include <HAL/PlatformFileManager.h>
+#include <Misc/QueuedThreadPool.h>
+#include <Misc/ConfigCacheIni.h>
+#include <Misc/PackageName.h>
 #include <ToolMenus.h>
 #include <ToolMenuEntry.h>
 #include <Framework/Application/SlateApplication.h>
+#include <Editor.h>
 #include <Editor/EditorEngine.h>
 #include <Subsystems/AssetEditorSubsystem.h>
 #include <Styling/AppStyle.h>
 
 #define LOCTEXT_NAMESPACE "MapPickerMenu"
 
+/** Read size used to pull map files into OS cache */
+static const int32 MapPrefetchChunkSize = 1024 * 1024;
+
+/** Stack of the prefetch thread, it only walks dependencies and reads into a heap buffer */
+static const uint32 MapPrefetchStackSize = 128 * 1024;
+
+static const int32 MapPickerMaxRecentMaps = 8;
+static const int32 MapPickerThumbnailPoolSize = 64;
+static const TCHAR* MapPickerConfigSection = TEXT("EditorMiscUtilities.MapPickerRecent");
+
 
 TSharedPtr<FMapPickerMenu> FMapPickerMenu::Create(FName InEntryName, FMapPicker_GetMaps Delegate, FText InMenuName /*= FText::GetEmpty()*/, FText InTooltip /*= FText::GetEmpty()*/, FName InIconStyle/* = NAME_None*/)
 {
@@ -28,12 +51,40 @@ TSharedPtr<FMapPickerMenu> FMapPickerMenu::Create(FName InEntryName, FMapPicker_
 		Picker->MenuTooltip = InTooltip.IsEmpty() ? LOCTEXT("DefaultMenuTooltip", "Some commonly desired maps while using the editor") : InTooltip;
 		Picker->IconStyle = InIconStyle.IsNone() ? TEXT("WorldBrowser.DetailsButtonBrush") : InIconStyle;
 
+		Picker->RefreshMaps();
+		Picker->LoadRecentMaps();
+		Picker->BeginPIEHandle = FEditorDelegates::BeginPIE.AddSP(Picker.ToSharedRef(), &FMapPickerMenu::OnBeginPIE);
+		Picker->EndPIEHandle = FEditorDelegates::EndPIE.AddSP(Picker.ToSharedRef(), &FMapPickerMenu::OnEndPIE);
+
 		UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateSP(Picker.ToSharedRef(), &FMapPickerMenu::RegisterGameEditorMenus));
 	}
 
 	return Picker;
 }
 
+FMapPickerMenu::~FMapPickerMenu()
+{
+	CancelPrefetch();
+
+	FEditorDelegates::BeginPIE.Remove(BeginPIEHandle);
+	FEditorDelegates::EndPIE.Remove(EndPIEHandle);
+
+	// Waits for the running prefetch, which stops at the next chunk once cancelled
+	if (PrefetchThread.IsValid())
+	{
+		PrefetchThread->Destroy();
+	}
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+}
+
 void FMapPickerMenu::RegisterGameEditorMenus()
 {
 	const FName SectionName = TEXT("PlayGameExtensions");
@@ -62,56 +113,376 @@ void FMapPickerMenu::RegisterGameEditorMenus()
 	Section->AddEntry(CommonMapEntry);
 }
 
+void FMapPickerMenu::RefreshMaps()
+{
+	Maps = MapGetter.Execute();
+	MapsVersion++;
+
+	ValidateMaps();
+}
+
+void FMapPickerMenu::SetListAllMaps(bool bInListAllMaps)
+{
+	bListAllMaps = bInListAllMaps;
+	if (bListAllMaps)
+	{
+		FWorldAssetIndex::Get().Initialize();
+	}
+}
+
+void FMapPickerMenu::OnBeginPIE(const bool bIsSimulating)
+{
+	bHasPlayWorld = true;
+	CancelPrefetch();
+}
+
+void FMapPickerMenu::OnEndPIE(const bool bIsSimulating)
+{
+	bHasPlayWorld = false;
+}
+
 bool FMapPickerMenu::HasNoPlayWorld()
 {
-	return GEditor->PlayWorld == nullptr;
+	return !bHasPlayWorld;
 }
 
-void FMapPickerMenu::OpenCommonMap_Clicked(const FString MapPath)
+void FMapPickerMenu::OpenMap(const FSoftObjectPath& MapPath)
 {
-	if (ensure(MapPath.Len()))
+	if (ensure(MapPath.IsValid()))
 	{
-		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(MapPath);
+		FSlateApplication::Get().DismissAllMenus();
+
+		// Opening reads the same files, do not compete with it
+		CancelPrefetch();
+
+		// Map being closed is the most likely one to come back to
+		if (UWorld* EditorWorld = GEditor->GetEditorWorldContext().World())
+		{
+			AddRecentMap(FSoftObjectPath(EditorWorld));
+		}
+		AddRecentMap(MapPath);
+
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(MapPath.ToString());
 	}
 }
 
 bool FMapPickerMenu::CanShowCommonMaps()
 {
-	if (HasNoPlayWorld())
+	return !bHasPlayWorld && (bListAllMaps || Maps.Num() > 0);
+}
+
+TSharedRef<SWidget> FMapPickerMenu::GetCommonMapsDropdown()
+{
+	EDITORMISCUTILITIES_SCOPE(MapPicker);
+
+	// Validation is queued before registry finished loading, or list changed while previous check was running
+	ValidateMaps();
+
+	UWorld* EditorWorld = GEditor->GetEditorWorldContext().World();
+	for (const FSoftObjectPath& RecentMap : RecentMaps)
+	{
+		if (EditorWorld == nullptr || FSoftObjectPath(EditorWorld) != RecentMap)
+		{
+			Prefetch(RecentMap);
+			break;
+		}
+	}
+
+	if (!ThumbnailPool.IsValid())
 	{
-		const TArray<FSoftObjectPath>& Maps = MapGetter.Execute();
-		return Maps.Num() > 0;
+		ThumbnailPool = MakeShared<FAssetThumbnailPool>(MapPickerThumbnailPoolSize);
 	}
-	return false;
+
+	return SNew(SMapPicker)
+		.CommonMaps(&Maps)
+		.RecentMaps(&RecentMaps)
+		.bListAllMaps(bListAllMaps)
+		.ThumbnailPool(ThumbnailPool)
+		.OnMapPicked(this, &FMapPickerMenu::OpenMap)
+		.OnMapHovered(this, &FMapPickerMenu::Prefetch)
+		.IsMapMissing(this, &FMapPickerMenu::IsMapMissing);
 }
 
-TSharedRef<SWidget> FMapPickerMenu::GetCommonMapsDropdown()
+FMapPickerMenu::EMapState FMapPickerMenu::GetMapState(const FSoftObjectPath& MapPath) const
 {
-	FMenuBuilder MenuBuilder(true, nullptr);
+	const EMapState* State = MapStates.Find(MapPath);
+	return State ? *State : EMapState::Unknown;
+}
 
-	const TArray<FSoftObjectPath> Maps = MapGetter.Execute();
-	for (const FSoftObjectPath& Path : Maps)
+bool FMapPickerMenu::IsMapMissing(const FSoftObjectPath& MapPath) const
+{
+	const EMapState State = GetMapState(MapPath);
+	if (State != EMapState::Unknown)
 	{
-		if (!Path.IsValid())
+		return State == EMapState::Missing;
+	}
+
+	// Not validated, e.g. recent map
+	const FWorldAssetIndex& Index = FWorldAssetIndex::Get();
+	return Index.IsReady() && Index.Find(MapPath) == nullptr;
+}
+
+void FMapPickerMenu::LoadRecentMaps()
+{
+	TArray<FString> Paths;
+	GConfig->GetArray(MapPickerConfigSection, *EntryName.ToString(), Paths, GEditorPerProjectIni);
+
+	RecentMaps.Reset(Paths.Num());
+	for (const FString& Path : Paths)
+	{
+		FSoftObjectPath MapPath(Path);
+		if (MapPath.IsValid() && RecentMaps.Num() < MapPickerMaxRecentMaps)
 		{
-			continue;
+			RecentMaps.AddUnique(MapPath);
 		}
+	}
+}
+
+void FMapPickerMenu::AddRecentMap(const FSoftObjectPath& MapPath)
+{
+	// Unsaved and transient worlds can not be opened again
+	if (!MapPath.IsValid() || !FPackageName::IsValidLongPackageName(MapPath.GetLongPackageName()) || FPackageName::IsTempPackage(MapPath.GetLongPackageName()))
+	{
+		return;
+	}
 
-		const FText DisplayName = FText::FromString(Path.GetAssetName());
-		MenuBuilder.AddMenuEntry(
-			DisplayName,
-			LOCTEXT("CommonPathDescription", "Opens this map in the editor"),
-			FSlateIcon(),
-			FUIAction(
-				FExecuteAction::CreateSP(this, &FMapPickerMenu::OpenCommonMap_Clicked, Path.ToString()),
-				FCanExecuteAction::CreateSP(this, &FMapPickerMenu::HasNoPlayWorld),
-				FIsActionChecked(),
-				FIsActionButtonVisible::CreateSP(this, &FMapPickerMenu::HasNoPlayWorld)
-			)
-		);
-	}
-
-	return MenuBuilder.MakeWidget();
+	RecentMaps.Remove(MapPath);
+	RecentMaps.Insert(MapPath, 0);
+	if (RecentMaps.Num() > MapPickerMaxRecentMaps)
+	{
+		RecentMaps.SetNum(MapPickerMaxRecentMaps);
+	}
+
+	TArray<FString> Paths;
+	for (const FSoftObjectPath& RecentMap : RecentMaps)
+	{
+		Paths.Add(RecentMap.ToString());
+	}
+	GConfig->SetArray(MapPickerConfigSection, *EntryName.ToString(), Paths, GEditorPerProjectIni);
+}
+
+void FMapPickerMenu::ValidateMaps()
+{
+	// Registry events keep states of current snapshot up to date
+	if (bValidating || ValidatedMapsVersion == MapsVersion)
+	{
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// Results are meaningless until registry knows all assets
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		if (!FilesLoadedHandle.IsValid())
+		{
+			FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddSP(this, &FMapPickerMenu::ValidateMaps);
+		}
+		return;
+	}
+
+	if (!AssetAddedHandle.IsValid())
+	{
+		AssetAddedHandle = AssetRegistry.OnAssetAdded().AddSP(this, &FMapPickerMenu::OnAssetAdded);
+		AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddSP(this, &FMapPickerMenu::OnAssetRemoved);
+		AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddSP(this, &FMapPickerMenu::OnAssetRenamed);
+	}
+
+	if (Maps.Num() == 0)
+	{
+		MapStates.Empty();
+		ValidatedMapsVersion = MapsVersion;
+		return;
+	}
+
+	bValidating = true;
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis = TWeakPtr<FMapPickerMenu>(AsShared()), WorldClassPath = UWorld::StaticClass()->GetClassPathName(), Version = MapsVersion, MapsToCheck = Maps]()
+	{
+		// Registry may be gone if the editor shut down while the task waited in the pool
+		const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		if (AssetRegistry == nullptr)
+		{
+			return;
+		}
+
+		TMap<FSoftObjectPath, EMapState> States;
+		for (const FSoftObjectPath& Path : MapsToCheck)
+		{
+			// On disk only, in-memory lookup is not safe off game thread
+			const FAssetData AssetData = AssetRegistry->GetAssetByObjectPath(Path, true);
+			States.Add(Path, AssetData.IsValid() && AssetData.AssetClassPath == WorldClassPath ? EMapState::Valid : EMapState::Missing);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Version, States = MoveTemp(States)]() mutable
+		{
+			TSharedPtr<FMapPickerMenu> This = WeakThis.Pin();
+			if (!This.IsValid())
+			{
+				return;
+			}
+
+			This->bValidating = false;
+
+			// List changed while checking, results are for old snapshot
+			if (Version != This->MapsVersion)
+			{
+				This->ValidateMaps();
+				return;
+			}
+
+			for (const TPair<FSoftObjectPath, EMapState>& Pair : States)
+			{
+				if (Pair.Value == EMapState::Missing && This->GetMapState(Pair.Key) != EMapState::Missing)
+				{
+					UE_LOG(LogEditorMiscUtilities, Warning, TEXT("MapPicker: %s is not a map or does not exist"), *Pair.Key.ToString());
+				}
+			}
+
+			This->MapStates = MoveTemp(States);
+			This->ValidatedMapsVersion = Version;
+		});
+	});
+}
+
+void FMapPickerMenu::OnAssetAdded(const FAssetData& AssetData)
+{
+	EMapState* State = MapStates.Find(AssetData.GetSoftObjectPath());
+	if (State && AssetData.IsInstanceOf<UWorld>())
+	{
+		*State = EMapState::Valid;
+	}
+}
+
+void FMapPickerMenu::OnAssetRemoved(const FAssetData& AssetData)
+{
+	EMapState* State = MapStates.Find(AssetData.GetSoftObjectPath());
+	if (State && *State != EMapState::Missing)
+	{
+		UE_LOG(LogEditorMiscUtilities, Warning, TEXT("MapPicker: %s is not a map or does not exist"), *AssetData.GetSoftObjectPath().ToString());
+		*State = EMapState::Missing;
+	}
+}
+
+void FMapPickerMenu::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	EMapState* OldState = MapStates.Find(FSoftObjectPath(OldObjectPath));
+	if (OldState && *OldState != EMapState::Missing)
+	{
+		UE_LOG(LogEditorMiscUtilities, Warning, TEXT("MapPicker: %s is not a map or does not exist"), *OldObjectPath);
+		*OldState = EMapState::Missing;
+	}
+
+	OnAssetAdded(AssetData);
+}
+
+void FMapPickerMenu::Prefetch(const FSoftObjectPath& MapPath)
+{
+	if (!PrefetchEnabled.Get() || !MapPath.IsValid() || MapPath == PrefetchedMap || GetMapState(MapPath) == EMapState::Missing)
+	{
+		return;
+	}
+
+	UWorld* EditorWorld = GEditor->GetEditorWorldContext().World();
+	if (EditorWorld && FSoftObjectPath(EditorWorld) == MapPath)
+	{
+		return;
+	}
+
+	CancelPrefetch();
+	PrefetchedMap = MapPath;
+
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> Cancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+	PrefetchCancelled = Cancelled;
+
+	if (!PrefetchThread.IsValid())
+	{
+		PrefetchThread.Reset(FQueuedThreadPool::Allocate());
+		PrefetchThread->Create(1, MapPrefetchStackSize, TPri_Lowest, TEXT("MapPrefetch"));
+	}
+
+	// Dependency walk and reads both run on the prefetch thread, hover and dropdown open only queue the work
+	AsyncPool(*PrefetchThread, [Cancelled, MapPackage = MapPath.GetLongPackageFName()]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		// Registry may be gone if the editor shut down while the work was queued
+		const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		if (AssetRegistry == nullptr || *Cancelled)
+		{
+			return;
+		}
+
+		TArray<FName> Packages;
+		TSet<FName> Visited;
+		TArray<FName> Queue = { MapPackage };
+		while (Queue.Num() > 0 && !*Cancelled)
+		{
+			const FName PackageName = Queue.Pop(false);
+
+			bool bAlreadyVisited = false;
+			Visited.Add(PackageName, &bAlreadyVisited);
+			if (bAlreadyVisited || FPackageName::IsScriptPackage(PackageName.ToString()))
+			{
+				continue;
+			}
+
+			Packages.Add(PackageName);
+			AssetRegistry->GetDependencies(PackageName, Queue, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		}
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(MapPrefetchChunkSize);
+
+		int64 BytesRead = 0;
+		int32 NumFiles = 0;
+		for (const FName& PackageName : Packages)
+		{
+			if (*Cancelled)
+			{
+				break;
+			}
+
+			FString Filename;
+			if (!FPackageName::DoesPackageExist(PackageName.ToString(), &Filename))
+			{
+				continue;
+			}
+
+			TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*Filename));
+			if (!Handle.IsValid())
+			{
+				continue;
+			}
+
+			const int64 Size = Handle->Size();
+			for (int64 Offset = 0; Offset < Size && !*Cancelled; Offset += MapPrefetchChunkSize)
+			{
+				const int64 ReadSize = FMath::Min<int64>(MapPrefetchChunkSize, Size - Offset);
+				if (!Handle->Read(Buffer.GetData(), ReadSize))
+				{
+					break;
+				}
+				BytesRead += ReadSize;
+			}
+			NumFiles++;
+		}
+
+		UE_LOG(LogEditorMiscUtilities, Log, TEXT("MapPicker: Prefetched %d of %d packages (%.1f MB) for %s in %.2f s%s"),
+			NumFiles, Packages.Num(), BytesRead / (1024.0 * 1024.0), *MapPackage.ToString(), FPlatformTime::Seconds() - StartTime, *Cancelled ? TEXT(", cancelled") : TEXT(""));
+	});
+}
+
+void FMapPickerMenu::CancelPrefetch()
+{
+	if (PrefetchCancelled.IsValid())
+	{
+		*PrefetchCancelled = true;
+		PrefetchCancelled.Reset();
+	}
+	PrefetchedMap.Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
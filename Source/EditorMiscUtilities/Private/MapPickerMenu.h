@@ -3,21 +3,65 @@
 #pragma once
 
 #include <Templates/SharedPointer.h>
+#include <Misc/Attribute.h>
+#include <UObject/SoftObjectPath.h>
+#include <Templates/UniquePtr.h>
+#include <atomic>
 
 
+struct FAssetData;
+
 DECLARE_DELEGATE_RetVal(const TArray<FSoftObjectPath>&, FMapPicker_GetMaps);
 
 struct FMapPickerMenu : public TSharedFromThis<FMapPickerMenu>
 {	
 	static TSharedPtr<FMapPickerMenu> Create(FName EntryName, FMapPicker_GetMaps Delegate, FText MenuName = FText::GetEmpty(), FText Tooltip = FText::GetEmpty(), FName IconStyle = NAME_None);
 
+	~FMapPickerMenu();
+
+	/** Read dependencies of hovered and last opened map in background so opening it hits OS file cache */
+	void SetPrefetchEnabled(TAttribute<bool> InPrefetchEnabled) { PrefetchEnabled = InPrefetchEnabled; }
+
+	/** Take new snapshot of map list. Call when source of the list changes */
+	void RefreshMaps();
+
+	/** Also list every map in project, not only the ones from MapGetter */
+	void SetListAllMaps(bool bInListAllMaps);
+
 private:
+	enum class EMapState : uint8
+	{
+		Unknown,
+		Valid,
+		Missing
+	};
+
 	void RegisterGameEditorMenus();
+	void OnBeginPIE(const bool bIsSimulating);
+	void OnEndPIE(const bool bIsSimulating);
 	bool HasNoPlayWorld();
-	void OpenCommonMap_Clicked(const FString MapPath);
+	void OpenMap(const FSoftObjectPath& MapPath);
 	bool CanShowCommonMaps();
 	TSharedRef<SWidget> GetCommonMapsDropdown();
 
+	EMapState GetMapState(const FSoftObjectPath& MapPath) const;
+	bool IsMapMissing(const FSoftObjectPath& MapPath) const;
+
+	/** Recent maps are stored per user, per menu entry */
+	void LoadRecentMaps();
+	void AddRecentMap(const FSoftObjectPath& MapPath);
+
+	/** Check maps against asset registry off game thread, results are picked up by open menu. Once per snapshot of the list */
+	void ValidateMaps();
+
+	/** Keep validated states current between snapshots */
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	void Prefetch(const FSoftObjectPath& MapPath);
+	void CancelPrefetch();
+
 private:	
 	FName EntryName;
 	FText MenuName;
@@ -25,6 +69,38 @@ private:
 	FName IconStyle;
 
 	FMapPicker_GetMaps MapGetter;
+
+	/** Snapshot of MapGetter result, polled delegates and dropdown only read this */
+	TArray<FSoftObjectPath> Maps;
+	uint32 MapsVersion = 0;
+	bool bHasPlayWorld = false;
+	bool bListAllMaps = false;
+	FDelegateHandle BeginPIEHandle;
+	FDelegateHandle EndPIEHandle;
+
+	TMap<FSoftObjectPath, EMapState> MapStates;
+	bool bValidating = false;
+
+	/** MapsVersion that MapStates were built for */
+	uint32 ValidatedMapsVersion = 0;
+
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+
+	/** Most recent first */
+	TArray<FSoftObjectPath> RecentMaps;
+
+	/** Outlives dropdown so thumbnails are not reloaded on every open */
+	TSharedPtr<class FAssetThumbnailPool> ThumbnailPool;
+
+	TAttribute<bool> PrefetchEnabled = false;
+
+	/** Single lowest priority thread, so prefetch never takes a worker from the shared pool */
+	TUniquePtr<class FQueuedThreadPool> PrefetchThread;
+	FSoftObjectPath PrefetchedMap;
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> PrefetchCancelled;
 };
 
 
@@ -0,0 +1,258 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "SComponentTagPicker.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <Styling/AppStyle.h>
+#include <Widgets/Input/SButton.h>
+#include <Widgets/Input/SCheckBox.h>
+#include <Widgets/Input/SSearchBox.h>
+#include <Widgets/Layout/SBox.h>
+#include <Widgets/Text/STextBlock.h>
+#include <Widgets/Views/STableRow.h>
+
+#define LOCTEXT_NAMESPACE "ComponentTagPicker"
+
+
+void SComponentTagPicker::Construct(const FArguments& InArgs)
+{
+	MenuData = InArgs._MenuData;
+	OnTagsPicked = InArgs._OnTagsPicked;
+
+	if (MenuData.IsValid())
+	{
+		FilteredCategories = MenuData->CategoryItems;
+	}
+
+	ChildSlot
+	[
+		SNew(SBox)
+		.WidthOverride(300)
+		.MaxDesiredHeight(450)
+		[
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot().AutoHeight().Padding(4)
+			[
+				SAssignNew(SearchBox, SSearchBox)
+				.HintText(LOCTEXT("SearchHint", "Search tags"))
+				.OnTextChanged(this, &SComponentTagPicker::OnSearchTextChanged)
+				.OnTextCommitted(this, &SComponentTagPicker::OnSearchTextCommitted)
+			]
+			+ SVerticalBox::Slot().FillHeight(1.0f)
+			[
+				SAssignNew(TreeView, STreeView<FItemPtr>)
+				.TreeItemsSource(&FilteredCategories)
+				.SelectionMode(ESelectionMode::Single)
+				.OnGenerateRow(this, &SComponentTagPicker::OnGenerateRow)
+				.OnGetChildren(this, &SComponentTagPicker::OnGetChildren)
+				.OnMouseButtonClick(this, &SComponentTagPicker::OnItemClicked)
+			]
+			+ SVerticalBox::Slot().AutoHeight().Padding(4)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.Visibility_Lambda([this]() { return CheckedTags.Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed; })
+				.Text_Lambda([this]() { return FText::Format(LOCTEXT("AddChecked", "Add {0} {0}|plural(one=Tag,other=Tags)"), CheckedTags.Num()); })
+				.OnClicked(this, &SComponentTagPicker::OnAddCheckedClicked)
+			]
+		]
+	];
+
+	for (const FItemPtr& Category : FilteredCategories)
+	{
+		TreeView->SetItemExpansion(Category, true);
+	}
+}
+
+TSharedPtr<SWidget> SComponentTagPicker::GetWidgetToFocusOnOpen() const
+{
+	return SearchBox;
+}
+
+void SComponentTagPicker::OnSearchTextChanged(const FText& InText)
+{
+	TArray<FString> Tokens;
+	InText.ToString().ToLower().ParseIntoArrayWS(Tokens);
+
+	// Typing more only removes matches, so previous result can be filtered further
+	bool bNarrowing = FilterTokens.Num() > 0 && Tokens.Num() >= FilterTokens.Num();
+	for (int32 Index = 0; bNarrowing && Index < FilterTokens.Num(); Index++)
+	{
+		bNarrowing = Tokens[Index].Contains(FilterTokens[Index]);
+	}
+
+	FilterTokens = MoveTemp(Tokens);
+	ApplyFilter(FilterTokens, bNarrowing);
+}
+
+void SComponentTagPicker::OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType)
+{
+	// Enter picks the only match
+	if (CommitType == ETextCommit::OnEnter && FilteredCategories.Num() == 1)
+	{
+		const TArray<FItemPtr>& Options = GetFilteredChildren(*FilteredCategories[0]);
+		if (Options.Num() == 1)
+		{
+			OnTagsPicked.ExecuteIfBound(TArray<FName>{ Options[0]->Option->Name });
+		}
+	}
+}
+
+void SComponentTagPicker::ApplyFilter(const TArray<FString>& Tokens, bool bNarrowing)
+{
+	EDITORMISCUTILITIES_SCOPE(TagMenu);
+
+	if (!MenuData.IsValid())
+	{
+		return;
+	}
+
+	const TArray<FItemPtr>& AllCategories = MenuData->CategoryItems;
+	if (Tokens.Num() == 0)
+	{
+		FilteredCategories = AllCategories;
+		FilteredChildren.Empty();
+	}
+	else
+	{
+		const TArray<FItemPtr>& SourceCategories = bNarrowing ? FilteredCategories : AllCategories;
+
+		TArray<FItemPtr> NewCategories;
+		TArray<TArray<FItemPtr>> NewChildren;
+		NewChildren.SetNum(AllCategories.Num());
+		for (const FItemPtr& Category : SourceCategories)
+		{
+			TArray<FItemPtr>& Matches = NewChildren[Category->CategoryIndex];
+			for (const FItemPtr& Option : bNarrowing ? GetFilteredChildren(*Category) : Category->Children)
+			{
+				if (PassesFilter(*Option, Tokens))
+				{
+					Matches.Add(Option);
+				}
+			}
+
+			if (Matches.Num() > 0)
+			{
+				NewCategories.Add(Category);
+			}
+		}
+
+		FilteredCategories = MoveTemp(NewCategories);
+		FilteredChildren = MoveTemp(NewChildren);
+	}
+
+	// Category items are the same on every keystroke, so this only re-expands ones collapsed by hand
+	for (const FItemPtr& Category : FilteredCategories)
+	{
+		TreeView->SetItemExpansion(Category, true);
+	}
+	TreeView->RequestTreeRefresh();
+}
+
+bool SComponentTagPicker::PassesFilter(const FItem& Item, const TArray<FString>& Tokens) const
+{
+	const FActorComponentTagsCustomization::FTagCategory& Category = MenuData->Categories[Item.CategoryIndex];
+	const FString& SearchString = Category.SearchStrings[Item.OptionIndex];
+
+	for (const FString& Token : Tokens)
+	{
+		if (!SearchString.Contains(Token, ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+TSharedRef<ITableRow> SComponentTagPicker::OnGenerateRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (Item->Option == nullptr)
+	{
+		const FString& CategoryName = MenuData->Categories[Item->CategoryIndex].Name;
+
+		return SNew(STableRow<FItemPtr>, OwnerTable)
+			.ShowSelection(false)
+			.Padding(FMargin(0, 4, 0, 2))
+			[
+				SNew(STextBlock)
+				.Text(CategoryName.IsEmpty() ? LOCTEXT("DefaultCategory", "Common") : FText::FromString(CategoryName))
+				.Font(FAppStyle::GetFontStyle("PropertyWindow.BoldFont"))
+			];
+	}
+
+	const FName Tag = Item->Option->Name;
+
+	return SNew(STableRow<FItemPtr>, OwnerTable)
+		.ToolTipText(FText::FromString(Item->Option->Description))
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center).Padding(0, 0, 4, 0)
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &SComponentTagPicker::IsTagChecked, Tag)
+				.OnCheckStateChanged(this, &SComponentTagPicker::OnTagCheckStateChanged, Tag)
+			]
+			+ SHorizontalBox::Slot().FillWidth(1.0f).VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromName(Tag))
+				.HighlightText_Lambda([this]() { return SearchBox.IsValid() ? SearchBox->GetText() : FText::GetEmpty(); })
+			]
+		];
+}
+
+void SComponentTagPicker::OnGetChildren(FItemPtr Item, TArray<FItemPtr>& OutChildren)
+{
+	OutChildren = GetFilteredChildren(*Item);
+}
+
+const TArray<SComponentTagPicker::FItemPtr>& SComponentTagPicker::GetFilteredChildren(const FItem& Category) const
+{
+	return FilteredChildren.IsValidIndex(Category.CategoryIndex) && Category.Option == nullptr ? FilteredChildren[Category.CategoryIndex] : Category.Children;
+}
+
+void SComponentTagPicker::OnItemClicked(FItemPtr Item)
+{
+	if (Item.IsValid() && Item->Option)
+	{
+		// While collecting tags clicks toggle them instead of picking
+		if (CheckedTags.Num() > 0)
+		{
+			OnTagCheckStateChanged(IsTagChecked(Item->Option->Name) == ECheckBoxState::Checked ? ECheckBoxState::Unchecked : ECheckBoxState::Checked, Item->Option->Name);
+		}
+		else
+		{
+			OnTagsPicked.ExecuteIfBound(TArray<FName>{ Item->Option->Name });
+		}
+	}
+	else if (Item.IsValid())
+	{
+		TreeView->SetItemExpansion(Item, !TreeView->IsItemExpanded(Item));
+	}
+}
+
+ECheckBoxState SComponentTagPicker::IsTagChecked(FName Tag) const
+{
+	return CheckedTags.Contains(Tag) ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SComponentTagPicker::OnTagCheckStateChanged(ECheckBoxState NewState, FName Tag)
+{
+	if (NewState == ECheckBoxState::Checked)
+	{
+		CheckedTags.AddUnique(Tag);
+	}
+	else
+	{
+		CheckedTags.Remove(Tag);
+	}
+}
+
+FReply SComponentTagPicker::OnAddCheckedClicked()
+{
+	OnTagsPicked.ExecuteIfBound(CheckedTags);
+	CheckedTags.Reset();
+	return FReply::Handled();
+}
+
+#undef LOCTEXT_NAMESPACE
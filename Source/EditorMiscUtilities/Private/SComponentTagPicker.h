@@ -0,0 +1,67 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Widgets/SCompoundWidget.h>
+#include <Widgets/Views/STreeView.h>
+#include "ComponentTagCustomization.h"
+
+class SSearchBox;
+
+DECLARE_DELEGATE_OneParam(FOnComponentTagsPicked, const TArray<FName>& /*Tags*/);
+
+/**
+ * Searchable tag list grouped by category. Rows are generated only for visible items.
+ * Clicking a tag picks it, checking several tags picks them together
+ */
+class SComponentTagPicker : public SCompoundWidget
+{
+public:
+	using FTagMenuData = FActorComponentTagsCustomization::FTagMenuData;
+
+	SLATE_BEGIN_ARGS(SComponentTagPicker)
+	{}
+		SLATE_ARGUMENT(TSharedPtr<const FTagMenuData>, MenuData)
+		SLATE_EVENT(FOnComponentTagsPicked, OnTagsPicked)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	TSharedPtr<SWidget> GetWidgetToFocusOnOpen() const;
+
+private:
+	using FItem = FActorComponentTagsCustomization::FTagMenuItem;
+	using FItemPtr = TSharedPtr<const FItem>;
+
+	void OnSearchTextChanged(const FText& InText);
+	void OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType);
+	void ApplyFilter(const TArray<FString>& Tokens, bool bNarrowing);
+	bool PassesFilter(const FItem& Item, const TArray<FString>& Tokens) const;
+
+	TSharedRef<ITableRow> OnGenerateRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetChildren(FItemPtr Item, TArray<FItemPtr>& OutChildren);
+	const TArray<FItemPtr>& GetFilteredChildren(const FItem& Category) const;
+	void OnItemClicked(FItemPtr Item);
+
+	ECheckBoxState IsTagChecked(FName Tag) const;
+	void OnTagCheckStateChanged(ECheckBoxState NewState, FName Tag);
+	FReply OnAddCheckedClicked();
+
+	TSharedPtr<const FTagMenuData> MenuData;
+	FOnComponentTagsPicked OnTagsPicked;
+
+	/** Tags checked for multi-add, in order of checking */
+	TArray<FName> CheckedTags;
+
+	/** Categories with options passing current filter. Items are shared with menu data, so expansion state stays with them */
+	TArray<FItemPtr> FilteredCategories;
+
+	/** Options passing current filter by category index. Empty when nothing is filtered */
+	TArray<TArray<FItemPtr>> FilteredChildren;
+
+	TArray<FString> FilterTokens;
+
+	TSharedPtr<SSearchBox> SearchBox;
+	TSharedPtr<STreeView<FItemPtr>> TreeView;
+};
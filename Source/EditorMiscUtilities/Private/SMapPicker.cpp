@@ -0,0 +1,300 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "SMapPicker.h"
+#include "WorldAssetIndex.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <AssetThumbnail.h>
+#include <Framework/Application/SlateApplication.h>
+#include <Styling/AppStyle.h>
+#include <Widgets/Input/SSearchBox.h>
+#include <Widgets/Layout/SBorder.h>
+#include <Widgets/Layout/SBox.h>
+#include <Widgets/Text/STextBlock.h>
+#include <Widgets/Views/STableRow.h>
+
+#define LOCTEXT_NAMESPACE "MapPicker"
+
+/** Size of map thumbnails in rows */
+static const int32 MapPickerThumbnailSize = 32;
+
+
+void SMapPicker::Construct(const FArguments& InArgs)
+{
+	CommonMaps = InArgs._CommonMaps;
+	RecentMaps = InArgs._RecentMaps;
+	bListAllMaps = InArgs._bListAllMaps;
+	ThumbnailPool = InArgs._ThumbnailPool;
+	OnMapPicked = InArgs._OnMapPicked;
+	OnMapHovered = InArgs._OnMapHovered;
+	IsMapMissing = InArgs._IsMapMissing;
+
+	RebuildItems();
+
+	ChildSlot
+	[
+		SNew(SBox)
+		.WidthOverride(350)
+		.MaxDesiredHeight(500)
+		[
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot().AutoHeight().Padding(4)
+			[
+				SAssignNew(SearchBox, SSearchBox)
+				.HintText(LOCTEXT("SearchHint", "Search maps"))
+				.OnTextChanged(this, &SMapPicker::OnSearchTextChanged)
+				.OnTextCommitted(this, &SMapPicker::OnSearchTextCommitted)
+			]
+			+ SVerticalBox::Slot().FillHeight(1.0f)
+			[
+				SAssignNew(ListView, SListView<FItemPtr>)
+				.ListItemsSource(&Items)
+				.SelectionMode(ESelectionMode::Single)
+				.OnGenerateRow(this, &SMapPicker::OnGenerateRow)
+				.OnMouseButtonClick(this, &SMapPicker::OnItemClicked)
+			]
+		]
+	];
+
+	// Menu content gets no focus of its own, start typing right away
+	RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateLambda([this](double, float)
+	{
+		FSlateApplication::Get().SetKeyboardFocus(SearchBox, EFocusCause::SetDirectly);
+		return EActiveTimerReturnType::Stop;
+	}));
+}
+
+SMapPicker::FItemPtr SMapPicker::MakeItem(const FSoftObjectPath& Path)
+{
+	if (const FItemPtr* Cached = ItemCache.Find(Path))
+	{
+		return *Cached;
+	}
+
+	FItemPtr Item = MakeShared<FItem>();
+	Item->Path = Path;
+	if (const FWorldAssetIndex::FEntry* Entry = FWorldAssetIndex::Get().Find(Path))
+	{
+		Item->AssetData = Entry->AssetData;
+	}
+
+	ItemCache.Add(Path, Item);
+	return Item;
+}
+
+void SMapPicker::AddSection(const FText& Name, const TArray<FSoftObjectPath>& Paths, TSet<FSoftObjectPath>& Added)
+{
+	const int32 HeaderIndex = Items.Num();
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		bool bAlreadyAdded = false;
+		Added.Add(Path, &bAlreadyAdded);
+		if (Path.IsValid() && !bAlreadyAdded)
+		{
+			Items.Add(MakeItem(Path));
+		}
+	}
+
+	if (Items.Num() > HeaderIndex)
+	{
+		FItemPtr Header = MakeShared<FItem>();
+		Header->Name = Name;
+		Items.Insert(Header, HeaderIndex);
+	}
+}
+
+void SMapPicker::OnSearchTextChanged(const FText& InText)
+{
+	EDITORMISCUTILITIES_SCOPE(MapPicker);
+
+	Query = InText.ToString().ToLower();
+	RebuildItems();
+	ListView->RequestListRefresh();
+	ListView->ScrollToTop();
+
+	if (!Query.IsEmpty() && Items.Num() > 0)
+	{
+		ListView->SetSelection(Items[0]);
+	}
+}
+
+void SMapPicker::OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType)
+{
+	if (CommitType == ETextCommit::OnEnter)
+	{
+		TArray<FItemPtr> Selected = ListView->GetSelectedItems();
+		if (Selected.Num() > 0)
+		{
+			OnItemClicked(Selected[0]);
+		}
+	}
+}
+
+void SMapPicker::RebuildItems()
+{
+	Items.Reset();
+
+	const FWorldAssetIndex& Index = FWorldAssetIndex::Get();
+	const bool bUseIndex = bListAllMaps && Index.IsReady();
+
+	if (Query.IsEmpty())
+	{
+		TSet<FSoftObjectPath> Added;
+		if (RecentMaps)
+		{
+			AddSection(LOCTEXT("RecentSection", "Recent"), *RecentMaps, Added);
+		}
+		if (CommonMaps)
+		{
+			AddSection(LOCTEXT("CommonSection", "Common"), *CommonMaps, Added);
+		}
+
+		if (bUseIndex)
+		{
+			TArray<FSoftObjectPath> AllMaps;
+			AllMaps.Reserve(Index.GetEntries().Num());
+			for (const FWorldAssetIndex::FEntry& Entry : Index.GetEntries())
+			{
+				AllMaps.Add(Entry.AssetData.GetSoftObjectPath());
+			}
+			AddSection(LOCTEXT("AllSection", "All Maps"), AllMaps, Added);
+		}
+		return;
+	}
+
+	struct FMatch
+	{
+		FItemPtr Item;
+		int32 Score;
+		int32 Length;
+	};
+	TArray<FMatch> Matches;
+	TSet<FSoftObjectPath> Seen;
+
+	auto TryMatch = [this, &Matches, &Seen](const FSoftObjectPath& Path, const FString& SearchName)
+	{
+		bool bAlreadySeen = false;
+		Seen.Add(Path, &bAlreadySeen);
+		if (bAlreadySeen || !Path.IsValid())
+		{
+			return;
+		}
+
+		const int32 Score = FWorldAssetIndex::FuzzyScore(Query, SearchName);
+		if (Score != INDEX_NONE)
+		{
+			Matches.Add({ MakeItem(Path), Score, SearchName.Len() });
+		}
+	};
+
+	for (const TArray<FSoftObjectPath>* Paths : { RecentMaps, CommonMaps })
+	{
+		if (Paths)
+		{
+			for (const FSoftObjectPath& Path : *Paths)
+			{
+				TryMatch(Path, Path.GetAssetName().ToLower());
+			}
+		}
+	}
+
+	if (bUseIndex)
+	{
+		for (const FWorldAssetIndex::FEntry& Entry : Index.GetEntries())
+		{
+			TryMatch(Entry.AssetData.GetSoftObjectPath(), Entry.SearchName);
+		}
+	}
+
+	// Best score first, shorter names win ties
+	Matches.StableSort([](const FMatch& A, const FMatch& B)
+	{
+		return A.Score != B.Score ? A.Score > B.Score : A.Length < B.Length;
+	});
+
+	Items.Reserve(Matches.Num());
+	for (const FMatch& Match : Matches)
+	{
+		Items.Add(Match.Item);
+	}
+}
+
+TSharedRef<ITableRow> SMapPicker::OnGenerateRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!Item->Path.IsValid())
+	{
+		return SNew(STableRow<FItemPtr>, OwnerTable)
+			.ShowSelection(false)
+			.Padding(FMargin(0, 4, 0, 2))
+			[
+				SNew(STextBlock)
+				.Text(Item->Name)
+				.Font(FAppStyle::GetFontStyle("PropertyWindow.BoldFont"))
+			];
+	}
+
+	EDITORMISCUTILITIES_COUNT(MapPickerEntries, 1);
+
+	// Thumbnails are loaded by pool only for rows that were ever visible
+	if (!Item->Thumbnail.IsValid() && Item->AssetData.IsValid() && ThumbnailPool.IsValid())
+	{
+		Item->Thumbnail = MakeShared<FAssetThumbnail>(Item->AssetData, MapPickerThumbnailSize, MapPickerThumbnailSize, ThumbnailPool);
+	}
+
+	const bool bMissing = IsMapMissing.IsBound() && IsMapMissing.Execute(Item->Path);
+	const FSoftObjectPath Path = Item->Path;
+
+	TSharedRef<SBorder> Content = SNew(SBorder)
+		.BorderImage(FAppStyle::GetNoBrush())
+		.Padding(0)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().AutoWidth().Padding(2)
+			[
+				SNew(SBox)
+				.WidthOverride(MapPickerThumbnailSize)
+				.HeightOverride(MapPickerThumbnailSize)
+				[
+					Item->Thumbnail.IsValid() ? Item->Thumbnail->MakeThumbnailWidget() : SNullWidget::NullWidget
+				]
+			]
+			+ SHorizontalBox::Slot().FillWidth(1.0f).VAlign(VAlign_Center).Padding(4, 0)
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot().AutoHeight()
+				[
+					SNew(STextBlock)
+					.Text(FText::FromString(Path.GetAssetName()))
+					.ColorAndOpacity(bMissing ? FSlateColor::UseSubduedForeground() : FSlateColor::UseForeground())
+				]
+				+ SVerticalBox::Slot().AutoHeight()
+				[
+					SNew(STextBlock)
+					.Text(bMissing ? LOCTEXT("MissingMap", "Not found in asset registry") : FText::FromString(Path.GetLongPackageName()))
+					.Font(FAppStyle::GetFontStyle("SmallFont"))
+					.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+				]
+			]
+		];
+
+	Content->SetOnMouseEnter(FNoReplyPointerEventHandler::CreateSPLambda(this, [this, Path](const FGeometry&, const FPointerEvent&)
+	{
+		OnMapHovered.ExecuteIfBound(Path);
+	}));
+
+	return SNew(STableRow<FItemPtr>, OwnerTable)
+		.ToolTipText(FText::FromString(Path.ToString()))
+		[
+			Content
+		];
+}
+
+void SMapPicker::OnItemClicked(FItemPtr Item)
+{
+	if (Item.IsValid() && Item->Path.IsValid() && !(IsMapMissing.IsBound() && IsMapMissing.Execute(Item->Path)))
+	{
+		OnMapPicked.ExecuteIfBound(Item->Path);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
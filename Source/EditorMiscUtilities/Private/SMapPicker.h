@@ -0,0 +1,82 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Widgets/SCompoundWidget.h>
+#include <Widgets/Views/SListView.h>
+#include <AssetRegistry/AssetData.h>
+
+class SSearchBox;
+class FAssetThumbnail;
+class FAssetThumbnailPool;
+
+DECLARE_DELEGATE_OneParam(FOnMapPickerMap, const FSoftObjectPath& /*Map*/);
+DECLARE_DELEGATE_RetVal_OneParam(bool, FMapPickerIsMapMissing, const FSoftObjectPath& /*Map*/);
+
+/**
+ * Searchable map list with recent, common and optionally all project maps.
+ * Rows and thumbnails are created only for visible items
+ */
+class SMapPicker : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMapPicker)
+		: _CommonMaps(nullptr)
+		, _RecentMaps(nullptr)
+		, _bListAllMaps(false)
+	{}
+		SLATE_ARGUMENT(const TArray<FSoftObjectPath>*, CommonMaps)
+		SLATE_ARGUMENT(const TArray<FSoftObjectPath>*, RecentMaps)
+		SLATE_ARGUMENT(bool, bListAllMaps)
+		SLATE_ARGUMENT(TSharedPtr<FAssetThumbnailPool>, ThumbnailPool)
+		SLATE_EVENT(FOnMapPickerMap, OnMapPicked)
+		SLATE_EVENT(FOnMapPickerMap, OnMapHovered)
+		SLATE_EVENT(FMapPickerIsMapMissing, IsMapMissing)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+private:
+	struct FItem
+	{
+		/** Empty for section rows */
+		FSoftObjectPath Path;
+		FText Name;
+
+		/** Invalid if map is not in registry */
+		FAssetData AssetData;
+
+		/** Created when row is first shown */
+		TSharedPtr<FAssetThumbnail> Thumbnail;
+	};
+	using FItemPtr = TSharedPtr<FItem>;
+
+	FItemPtr MakeItem(const FSoftObjectPath& Path);
+	void AddSection(const FText& Name, const TArray<FSoftObjectPath>& Paths, TSet<FSoftObjectPath>& Added);
+
+	void OnSearchTextChanged(const FText& InText);
+	void OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType);
+	void RebuildItems();
+
+	TSharedRef<ITableRow> OnGenerateRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnItemClicked(FItemPtr Item);
+
+	const TArray<FSoftObjectPath>* CommonMaps = nullptr;
+	const TArray<FSoftObjectPath>* RecentMaps = nullptr;
+	bool bListAllMaps = false;
+	TSharedPtr<FAssetThumbnailPool> ThumbnailPool;
+
+	FOnMapPickerMap OnMapPicked;
+	FOnMapPickerMap OnMapHovered;
+	FMapPickerIsMapMissing IsMapMissing;
+
+	/** Items shared between sections and search results, keeps thumbnails alive while picker is open */
+	TMap<FSoftObjectPath, FItemPtr> ItemCache;
+
+	TArray<FItemPtr> Items;
+	FString Query;
+
+	TSharedPtr<SSearchBox> SearchBox;
+	TSharedPtr<SListView<FItemPtr>> ListView;
+};
@@ -0,0 +1,63 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "ComponentTagCustomization.h"
+#include "SComponentTagPicker.h"
+
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentTagPickerOpenBenchmark, "EditorMiscUtilities.ComponentTags.PickerOpen10k", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FComponentTagPickerOpenBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumCategories = 100;
+	const int32 NumTagsPerCategory = 100;
+	const int32 Iterations = 5;
+
+	// Sorted by category, as settings hand them out
+	TSharedRef<TArray<FActorComponentTagOptionInfo>> Options = MakeShared<TArray<FActorComponentTagOptionInfo>>();
+	Options->Reserve(NumCategories * NumTagsPerCategory);
+	for (int32 CategoryIndex = 0; CategoryIndex < NumCategories; CategoryIndex++)
+	{
+		const FString Category = FString::Printf(TEXT("Category_%03d"), CategoryIndex);
+		for (int32 TagIndex = 0; TagIndex < NumTagsPerCategory; TagIndex++)
+		{
+			Options->Emplace(*FString::Printf(TEXT("Tag_%d_%d"), CategoryIndex, TagIndex), Category, FString::Printf(TEXT("Synthetic tag %d of category %d"), TagIndex, CategoryIndex));
+		}
+	}
+
+	double BuildSeconds = 0;
+	double OpenSeconds = 0;
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		TSharedRef<const FActorComponentTagsCustomization::FTagMenuData> MenuData = FActorComponentTagsCustomization::BuildTagMenuData(Options);
+		BuildSeconds += FPlatformTime::Seconds() - StartTime;
+
+		// Same work as opening the combo button menu, rows are created for visible items only
+		StartTime = FPlatformTime::Seconds();
+		TSharedRef<SComponentTagPicker> Picker = SNew(SComponentTagPicker).MenuData(MenuData);
+		Picker->SlatePrepass();
+		OpenSeconds += FPlatformTime::Seconds() - StartTime;
+
+		if (Iteration == 0)
+		{
+			int32 NumOptions = 0;
+			for (const FActorComponentTagsCustomization::FTagCategory& Category : MenuData->Categories)
+			{
+				NumOptions += Category.Options.Num();
+			}
+			TestEqual(TEXT("Categories"), MenuData->Categories.Num(), NumCategories);
+			TestEqual(TEXT("Category items"), MenuData->CategoryItems.Num(), NumCategories);
+			TestEqual(TEXT("Options"), NumOptions, NumCategories * NumTagsPerCategory);
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Tag menu with %d tags: build %.3f ms, open %.3f ms (mean of %d)"),
+		Options->Num(), BuildSeconds * 1000.0 / Iterations, OpenSeconds * 1000.0 / Iterations, Iterations));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
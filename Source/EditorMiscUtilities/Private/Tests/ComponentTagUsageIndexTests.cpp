@@ -0,0 +1,36 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "ComponentTagUsageIndex.h"
+
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentTagUsageParseTest, "EditorMiscUtilities.ComponentTags.UsageParse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FComponentTagUsageParseTest::RunTest(const FString& Parameters)
+{
+	TArray<FComponentTagUsageIndex::FTagCount> Counts;
+	FComponentTagUsageIndex::ParseTagValue(TEXT("/Script/Engine.SceneComponent=Door:2,Loot:1;/Script/Engine.StaticMeshComponent=Door:3;Broken;/Script/Engine.BoxComponent="), Counts);
+
+	if (!TestEqual(TEXT("Entries"), Counts.Num(), 3))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("First class"), Counts[0].ComponentClass, FString(TEXT("/Script/Engine.SceneComponent")));
+	TestEqual(TEXT("First tag"), Counts[0].Tag, FName(TEXT("Door")));
+	TestEqual(TEXT("First count"), Counts[0].Count, 2);
+	TestEqual(TEXT("Second tag"), Counts[1].Tag, FName(TEXT("Loot")));
+	TestEqual(TEXT("Second count"), Counts[1].Count, 1);
+	TestEqual(TEXT("Third class"), Counts[2].ComponentClass, FString(TEXT("/Script/Engine.StaticMeshComponent")));
+	TestEqual(TEXT("Third count"), Counts[2].Count, 3);
+
+	Counts.Reset();
+	FComponentTagUsageIndex::ParseTagValue(FString(), Counts);
+	TestEqual(TEXT("Empty value"), Counts.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,114 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailDrawing.h"
+
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace EasyThumbnailDrawingTests
+{
+	/** Tiles as the box brush used to draw them one FCanvasTileItem at a time, zero-area tiles dropped */
+	void BuildLegacyNineSlice(TArray<EasyThumbnail::FTile>& OutTiles, const FVector2D& Position, const FVector2D& Size, const FVector2D& NaturalSize, const FMargin& Margin)
+	{
+		const float Width = Size.X;
+		const float Height = Size.Y;
+
+		const float TopPx = FMath::Clamp<float>(NaturalSize.Y * Margin.Top, 0, Height);
+		const float BottomPx = FMath::Clamp<float>(NaturalSize.Y * Margin.Bottom, 0, Height);
+		const float VerticalCenterPx = FMath::Clamp<float>(Height - TopPx - BottomPx, 0, Height);
+		const float LeftPx = FMath::Clamp<float>(NaturalSize.X * Margin.Left, 0, Width);
+		const float RightPx = FMath::Clamp<float>(NaturalSize.X * Margin.Right, 0, Width);
+		const float HorizontalCenterPx = FMath::Clamp<float>(Width - LeftPx - RightPx, 0, Width);
+
+		auto AddTile = [&](const FVector2D& TilePosition, const FVector2D& TileSize, const FVector2D& UV0, const FVector2D& UV1)
+		{
+			if (TileSize.X > 0 && TileSize.Y > 0)
+			{
+				OutTiles.Add({ Position + TilePosition, TileSize, UV0, UV1 });
+			}
+		};
+
+		// Top-Left, Bottom-Left, Top-Right, Bottom-Right
+		AddTile(FVector2D(0, 0), FVector2D(LeftPx, TopPx), FVector2D(0, 0), FVector2D(Margin.Left, Margin.Top));
+		AddTile(FVector2D(0, Height - BottomPx), FVector2D(LeftPx, BottomPx), FVector2D(0, 1 - Margin.Bottom), FVector2D(Margin.Left, 1));
+		AddTile(FVector2D(Width - RightPx, 0), FVector2D(RightPx, TopPx), FVector2D(1 - Margin.Right, 0), FVector2D(1, Margin.Top));
+		AddTile(FVector2D(Width - RightPx, Height - BottomPx), FVector2D(RightPx, BottomPx), FVector2D(1 - Margin.Right, 1 - Margin.Bottom), FVector2D(1, 1));
+
+		// Center-Vertical-Left, Center-Vertical-Right
+		AddTile(FVector2D(0, TopPx), FVector2D(LeftPx, VerticalCenterPx), FVector2D(0, Margin.Top), FVector2D(Margin.Left, 1 - Margin.Bottom));
+		AddTile(FVector2D(Width - RightPx, TopPx), FVector2D(RightPx, VerticalCenterPx), FVector2D(1 - Margin.Right, Margin.Top), FVector2D(1, 1 - Margin.Bottom));
+
+		// Center-Horizontal-Top, Center-Horizontal-Bottom
+		AddTile(FVector2D(LeftPx, 0), FVector2D(HorizontalCenterPx, TopPx), FVector2D(Margin.Left, 0), FVector2D(1 - Margin.Right, Margin.Top));
+		AddTile(FVector2D(LeftPx, Height - BottomPx), FVector2D(HorizontalCenterPx, BottomPx), FVector2D(Margin.Left, 1 - Margin.Bottom), FVector2D(1 - Margin.Right, 1));
+
+		// Center
+		AddTile(FVector2D(LeftPx, TopPx), FVector2D(HorizontalCenterPx, VerticalCenterPx), FVector2D(Margin.Left, Margin.Top), FVector2D(1 - Margin.Right, 1 - Margin.Bottom));
+	}
+
+	bool IsSameTile(const EasyThumbnail::FTile& A, const EasyThumbnail::FTile& B)
+	{
+		return A.Position.Equals(B.Position, KINDA_SMALL_NUMBER)
+			&& A.Size.Equals(B.Size, KINDA_SMALL_NUMBER)
+			&& A.UV0.Equals(B.UV0, KINDA_SMALL_NUMBER)
+			&& A.UV1.Equals(B.UV1, KINDA_SMALL_NUMBER);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEasyThumbnailNineSliceTest, "EditorMiscUtilities.EasyThumbnail.NineSlice", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FEasyThumbnailNineSliceTest::RunTest(const FString& Parameters)
+{
+	using namespace EasyThumbnailDrawingTests;
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		FMargin Margin;
+	};
+
+	const FCase Cases[] =
+	{
+		{ TEXT("Zero"), FMargin(0) },
+		{ TEXT("Half"), FMargin(0.5f) },
+		{ TEXT("Asymmetric"), FMargin(0.1f, 0.2f, 0.3f, 0.4f) },
+		{ TEXT("Overlapping"), FMargin(0.7f) },
+		{ TEXT("OverlappingAsymmetric"), FMargin(0.9f, 0.05f, 0.6f, 0.8f) },
+	};
+
+	const FVector2D Position(3, 5);
+	const FVector2D Sizes[] = { FVector2D(64, 64), FVector2D(256, 128), FVector2D(16, 200) };
+	const FVector2D NaturalSize(128, 96);
+
+	for (const FCase& Case : Cases)
+	{
+		for (const FVector2D& Size : Sizes)
+		{
+			const FString What = FString::Printf(TEXT("%s %gx%g"), Case.Name, Size.X, Size.Y);
+
+			TArray<EasyThumbnail::FTile> Expected;
+			BuildLegacyNineSlice(Expected, Position, Size, NaturalSize, Case.Margin);
+
+			EasyThumbnail::FNineSliceTiles Actual;
+			EasyThumbnail::BuildNineSliceTiles(Actual, Position, Size, NaturalSize, Case.Margin);
+
+			if (!TestEqual(FString::Printf(TEXT("%s: tile count"), *What), Actual.Num(), Expected.Num()))
+			{
+				continue;
+			}
+
+			// Tile order differs, legacy drew corners first
+			for (const EasyThumbnail::FTile& Tile : Expected)
+			{
+				const bool bFound = Actual.ContainsByPredicate([&Tile](const EasyThumbnail::FTile& Other) { return IsSameTile(Tile, Other); });
+				TestTrue(FString::Printf(TEXT("%s: tile at (%g, %g) size (%g, %g) UV (%g, %g)-(%g, %g)"), *What,
+					Tile.Position.X, Tile.Position.Y, Tile.Size.X, Tile.Size.Y, Tile.UV0.X, Tile.UV0.Y, Tile.UV1.X, Tile.UV1.Y), bFound);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,77 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EasyThumbnailCache.h"
+
+#include <Engine/Texture2D.h>
+#include <Materials/Material.h>
+#include <Materials/MaterialInstanceConstant.h>
+#include <Misc/AutomationTest.h>
+#include <UObject/StrongObjectPtr.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace EasyThumbnailMaterialHashTests
+{
+	UMaterialInstanceConstant* MakeInstance()
+	{
+		UMaterialInstanceConstant* Instance = NewObject<UMaterialInstanceConstant>(GetTransientPackage(), NAME_None, RF_Transient);
+		Instance->SetParentEditorOnly(UMaterial::GetDefaultMaterial(MD_Surface));
+		return Instance;
+	}
+}
+
+/** Material brushes are cached by thumbnail cache under this hash, nothing is drawn so test passes with -nullrhi */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEasyThumbnailMaterialHashTest, "EditorMiscUtilities.EasyThumbnail.MaterialHash", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FEasyThumbnailMaterialHashTest::RunTest(const FString& Parameters)
+{
+	using namespace EasyThumbnailMaterialHashTests;
+
+	TestEqual(TEXT("Null material"), FEasyThumbnailCache::HashMaterial(nullptr), 0u);
+
+	// Parameter change changes the hash
+	{
+		TStrongObjectPtr<UMaterialInstanceConstant> Material(MakeInstance());
+		const FMaterialParameterInfo Brightness(TEXT("Brightness"));
+		Material->SetScalarParameterValueEditorOnly(Brightness, 1.0f);
+
+		const uint32 Hash = FEasyThumbnailCache::HashMaterial(Material.Get());
+		TestEqual(TEXT("Unchanged material keeps its hash"), FEasyThumbnailCache::HashMaterial(Material.Get()), Hash);
+
+		Material->SetScalarParameterValueEditorOnly(Brightness, 2.0f);
+		TestNotEqual(TEXT("Scalar parameter change changes hash"), FEasyThumbnailCache::HashMaterial(Material.Get()), Hash);
+
+		Material->SetScalarParameterValueEditorOnly(Brightness, 1.0f);
+		TestEqual(TEXT("Restored parameter restores hash"), FEasyThumbnailCache::HashMaterial(Material.Get()), Hash);
+	}
+
+	// Texture parameters hash by content id, not by pointer
+	{
+		TStrongObjectPtr<UTexture2D> Texture(UTexture2D::CreateTransient(4, 4));
+		Texture->SetLightingGuid();
+
+		TStrongObjectPtr<UMaterialInstanceConstant> Material(MakeInstance());
+		const FMaterialParameterInfo Image(TEXT("Image"));
+		Material->SetTextureParameterValueEditorOnly(Image, Texture.Get());
+
+		const uint32 Hash = FEasyThumbnailCache::HashMaterial(Material.Get());
+
+		Texture->SetLightingGuid();
+		TestNotEqual(TEXT("New texture content changes hash"), FEasyThumbnailCache::HashMaterial(Material.Get()), Hash);
+	}
+
+	// Same parameters give the same hash, identity of material is part of the cache key elsewhere
+	{
+		TStrongObjectPtr<UMaterialInstanceConstant> First(MakeInstance());
+		TStrongObjectPtr<UMaterialInstanceConstant> Second(MakeInstance());
+		const FMaterialParameterInfo Brightness(TEXT("Brightness"));
+		First->SetScalarParameterValueEditorOnly(Brightness, 3.0f);
+		Second->SetScalarParameterValueEditorOnly(Brightness, 3.0f);
+
+		TestEqual(TEXT("Hash does not depend on material path"), FEasyThumbnailCache::HashMaterial(First.Get()), FEasyThumbnailCache::HashMaterial(Second.Get()));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
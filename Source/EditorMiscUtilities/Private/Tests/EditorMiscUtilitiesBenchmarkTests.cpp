@@ -0,0 +1,53 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "EditorMiscUtilitiesBenchmark.h"
+
+#include <Framework/Application/SlateApplication.h>
+#include <Misc/AutomationTest.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Same cases as the benchmark commandlet, e.g. -ExecCmds="Automation RunTests EditorMiscUtilities.Benchmark;Quit" -nullrhi -unattended */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEditorMiscUtilitiesBenchmarkTest, "EditorMiscUtilities.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FEditorMiscUtilitiesBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace EditorMiscUtilitiesBenchmark;
+
+	const int32 Iterations = 10;
+
+	TArray<FResult> Results;
+	RunAll(Iterations, Results);
+
+	TArray<FString> Expected = { TEXT("ThumbnailRegistry.Register"), TEXT("Thumbnail.ResolveAndNineSlice"), TEXT("TagMenu.Build"), TEXT("HideClasses.Apply") };
+	if (FSlateApplication::IsInitialized())
+	{
+		Expected.Add(TEXT("Details.Rebuild.Default"));
+		Expected.Add(TEXT("Details.Rebuild.TagPicker"));
+	}
+
+	for (const FString& Name : Expected)
+	{
+		const FResult* Result = Results.FindByPredicate([&Name](const FResult& Each) { return Each.Name == Name; });
+		if (TestNotNull(*FString::Printf(TEXT("%s ran"), *Name), Result))
+		{
+			TestEqual(*FString::Printf(TEXT("%s samples"), *Name), Result->SamplesMs.Num(), Iterations);
+			TestTrue(*FString::Printf(TEXT("%s has work"), *Name), Result->WorkItems > 0);
+		}
+	}
+
+	for (const FResult& Result : Results)
+	{
+		AddInfo(FString::Printf(TEXT("%s: %d items, median %.3f ms, max %.3f ms"), *Result.Name, Result.WorkItems, Result.SamplesMs[Result.SamplesMs.Num() / 2], Result.SamplesMs.Last()));
+	}
+
+	// Separate from the commandlet result, so an automation run does not overwrite a reference run
+	const FString OutputPath = FPaths::ProjectSavedDir() / TEXT("EditorMiscUtilities") / TEXT("BenchmarkAutomation.json");
+	TestTrue(TEXT("Results written"), FFileHelper::SaveStringToFile(ToJsonString(Results, Iterations), *OutputPath));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
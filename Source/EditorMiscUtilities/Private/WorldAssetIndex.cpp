@@ -0,0 +1,217 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#include "WorldAssetIndex.h"
+#include "EditorMiscUtilitiesModule.h"
+#include "EditorMiscUtilitiesStats.h"
+
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Engine/World.h>
+
+
+FWorldAssetIndex& FWorldAssetIndex::Get()
+{
+	static FWorldAssetIndex Instance;
+	return Instance;
+}
+
+void FWorldAssetIndex::Initialize()
+{
+	if (bInitialized)
+	{
+		return;
+	}
+	bInitialized = true;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FWorldAssetIndex::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FWorldAssetIndex::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FWorldAssetIndex::OnAssetRenamed);
+
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FWorldAssetIndex::Rebuild);
+	}
+	else
+	{
+		Rebuild();
+	}
+}
+
+void FWorldAssetIndex::Shutdown()
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+	bInitialized = false;
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+
+	Entries.Empty();
+	EntryIndices.Empty();
+	bReady = false;
+}
+
+const TArray<FWorldAssetIndex::FEntry>& FWorldAssetIndex::GetEntries() const
+{
+	// Incremental changes append, order is restored on next read
+	if (!bSorted)
+	{
+		Entries.Sort([](const FEntry& A, const FEntry& B) { return A.SearchName < B.SearchName; });
+
+		EntryIndices.Reset();
+		for (int32 Index = 0; Index < Entries.Num(); Index++)
+		{
+			EntryIndices.Add(Entries[Index].AssetData.GetSoftObjectPath(), Index);
+		}
+		bSorted = true;
+	}
+	return Entries;
+}
+
+const FWorldAssetIndex::FEntry* FWorldAssetIndex::Find(const FSoftObjectPath& Path) const
+{
+	const int32* Index = EntryIndices.Find(Path);
+	return Index ? &Entries[*Index] : nullptr;
+}
+
+int32 FWorldAssetIndex::FuzzyScore(const FString& Query, const FString& Candidate)
+{
+	int32 Score = 0;
+	int32 CandidateIndex = 0;
+	int32 LastMatch = INDEX_NONE;
+
+	for (const TCHAR Char : Query)
+	{
+		if (FChar::IsWhitespace(Char))
+		{
+			continue;
+		}
+
+		int32 Match = INDEX_NONE;
+		for (; CandidateIndex < Candidate.Len(); CandidateIndex++)
+		{
+			if (Candidate[CandidateIndex] == Char)
+			{
+				Match = CandidateIndex++;
+				break;
+			}
+		}
+
+		if (Match == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		Score += 1;
+
+		// Runs of characters and word starts are what people type
+		if (Match == LastMatch + 1)
+		{
+			Score += 4;
+		}
+		if (Match == 0 || !FChar::IsAlnum(Candidate[Match - 1]))
+		{
+			Score += 3;
+		}
+		LastMatch = Match;
+	}
+
+	return Score;
+}
+
+void FWorldAssetIndex::Rebuild()
+{
+	EDITORMISCUTILITIES_SCOPE(MapPicker);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TArray<FAssetData> Worlds;
+	AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetClassPathName(), Worlds);
+
+	Entries.Reset(Worlds.Num());
+	EntryIndices.Reset();
+	for (const FAssetData& AssetData : Worlds)
+	{
+		AddEntry(AssetData);
+	}
+	bReady = true;
+	Version++;
+
+	UE_LOG(LogEditorMiscUtilities, Log, TEXT("WorldAssetIndex: Indexed %d maps in %.2f ms"), Entries.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FWorldAssetIndex::OnAssetAdded(const FAssetData& AssetData)
+{
+	// Initial scan is picked up by Rebuild
+	if (bReady && IsWorld(AssetData))
+	{
+		AddEntry(AssetData);
+		Version++;
+	}
+}
+
+void FWorldAssetIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+	if (bReady && IsWorld(AssetData))
+	{
+		RemoveEntry(AssetData.GetSoftObjectPath());
+		Version++;
+	}
+}
+
+void FWorldAssetIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (bReady && IsWorld(AssetData))
+	{
+		RemoveEntry(FSoftObjectPath(OldObjectPath));
+		AddEntry(AssetData);
+		Version++;
+	}
+}
+
+bool FWorldAssetIndex::IsWorld(const FAssetData& AssetData) const
+{
+	return AssetData.AssetClassPath == UWorld::StaticClass()->GetClassPathName();
+}
+
+void FWorldAssetIndex::AddEntry(const FAssetData& AssetData)
+{
+	const FSoftObjectPath Path = AssetData.GetSoftObjectPath();
+	if (EntryIndices.Contains(Path))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.AssetData = AssetData;
+	Entry.SearchName = AssetData.AssetName.ToString().ToLower();
+
+	EntryIndices.Add(Path, Entries.Num() - 1);
+	bSorted = false;
+}
+
+void FWorldAssetIndex::RemoveEntry(const FSoftObjectPath& Path)
+{
+	int32 Index = INDEX_NONE;
+	if (!EntryIndices.RemoveAndCopyValue(Path, Index))
+	{
+		return;
+	}
+
+	Entries.RemoveAtSwap(Index);
+	if (Entries.IsValidIndex(Index))
+	{
+		EntryIndices.Add(Entries[Index].AssetData.GetSoftObjectPath(), Index);
+	}
+	bSorted = false;
+}
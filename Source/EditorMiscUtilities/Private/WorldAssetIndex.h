@@ -0,0 +1,63 @@
+// Copyright (C) Vasily Bulgakov. 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <AssetRegistry/AssetData.h>
+
+/**
+ * Every UWorld asset known to asset registry.
+ * Built once when registry finishes scanning and kept current from registry events, so map pickers never query registry themselves
+ */
+class FWorldAssetIndex
+{
+public:
+	struct FEntry
+	{
+		FAssetData AssetData;
+
+		/** Lowercase asset name for fuzzy search */
+		FString SearchName;
+	};
+
+	static FWorldAssetIndex& Get();
+
+	void Initialize();
+	void Shutdown();
+
+	bool IsReady() const { return bReady; }
+
+	/** Entries sorted by name */
+	const TArray<FEntry>& GetEntries() const;
+
+	const FEntry* Find(const FSoftObjectPath& Path) const;
+
+	/** Incremented on every change */
+	uint32 GetVersion() const { return Version; }
+
+	/** Match characters of lowercase Query in order. Higher is better, INDEX_NONE if not matched */
+	static int32 FuzzyScore(const FString& Query, const FString& Candidate);
+
+private:
+	void Rebuild();
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	bool IsWorld(const FAssetData& AssetData) const;
+	void AddEntry(const FAssetData& AssetData);
+	void RemoveEntry(const FSoftObjectPath& Path);
+
+	mutable TArray<FEntry> Entries;
+	mutable TMap<FSoftObjectPath, int32> EntryIndices;
+	mutable bool bSorted = false;
+
+	uint32 Version = 0;
+	bool bInitialized = false;
+	bool bReady = false;
+
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+};
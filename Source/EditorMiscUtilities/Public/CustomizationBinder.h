@@ -4,9 +4,49 @@
 
 #include "CoreMinimal.h"
 #include "PropertyEditorModule.h"
+#include "PropertyHandle.h"
+#include <UObject/UnrealType.h>
 
+/**
+ * Keeps track of registered detail customizations and removes them in UnregisterAll.
+ * Registrations made before PropertyEditor is loaded are activated when it loads
+ */
 class FCustomizationBinder
 {
+public:
+	/** Matches native properties by pointer, resolved once from declaring struct and name. Every row of every details panel is asked, so a miss costs only a compare */
+	class FPropertyNameIdentifier : public IPropertyTypeIdentifier
+	{
+	public:
+		FPropertyNameIdentifier()
+		{
+
+		}
+
+		FPropertyNameIdentifier(const UStruct* OwnerStruct, FName PropertyName)
+		{
+			Add(OwnerStruct, PropertyName);
+		}
+
+		void Add(const UStruct* OwnerStruct, FName PropertyName)
+		{
+			const FProperty* Property = OwnerStruct ? FindFProperty<FProperty>(OwnerStruct, PropertyName) : nullptr;
+			if (ensureMsgf(Property, TEXT("Property %s not found in %s"), *PropertyName.ToString(), *GetNameSafe(OwnerStruct)))
+			{
+				Properties.AddUnique(Property);
+			}
+		}
+
+		virtual bool IsPropertyTypeCustomized(const IPropertyHandle& PropertyHandle) const override
+		{
+			return Properties.Contains(PropertyHandle.GetProperty());
+		}
+
+	private:
+		/** Inherited properties are the same object in child classes, including blueprints */
+		TArray<const FProperty*, TInlineAllocator<4>> Properties;
+	};
+
 public:
 	FCustomizationBinder()
 	{
@@ -18,14 +58,61 @@ public:
 		UnregisterAll();
 	}
 
-	void RegisterProperty(FPropertyEditorModule& PropertyModule, FName PropertyTypeName, FOnGetPropertyTypeCustomizationInstance PropertyTypeLayoutDelegate, TSharedPtr<IPropertyTypeIdentifier> Identifier = nullptr)
+	void RegisterProperty(FName PropertyTypeName, FOnGetPropertyTypeCustomizationInstance PropertyTypeLayoutDelegate, TSharedPtr<IPropertyTypeIdentifier> Identifier = nullptr)
 	{
-		PropertyModule.RegisterCustomPropertyTypeLayout(PropertyTypeName, PropertyTypeLayoutDelegate, Identifier);
+		FRegisteredCustomization& Customization = PropertyCustomizations.AddDefaulted_GetRef();
+		Customization.Name = PropertyTypeName;
+		Customization.Identifier = Identifier;
+		Customization.PropertyDelegate = PropertyTypeLayoutDelegate;
+		Flush();
 	}
 
-	void RegisterClass(FPropertyEditorModule& PropertyModule, FName ClassName, FOnGetDetailCustomizationInstance DetailLayoutDelegate)
+	void RegisterClass(FName ClassName, FOnGetDetailCustomizationInstance DetailLayoutDelegate)
 	{
-		PropertyModule.RegisterCustomClassLayout(ClassName, DetailLayoutDelegate);
+		FRegisteredCustomization& Customization = ClassCustomizations.AddDefaulted_GetRef();
+		Customization.Name = ClassName;
+		Customization.ClassDelegate = DetailLayoutDelegate;
+		Flush();
+	}
+
+	void UnregisterProperty(FName PropertyTypeName, TSharedPtr<IPropertyTypeIdentifier> Identifier = nullptr)
+	{
+		FPropertyEditorModule* PropertyModule = FModuleManager::GetModulePtr<FPropertyEditorModule>("PropertyEditor");
+		PropertyCustomizations.RemoveAll([&](const FRegisteredCustomization& Customization)
+		{
+			if (Customization.Name != PropertyTypeName || Customization.Identifier != Identifier)
+			{
+				return false;
+			}
+
+			if (Customization.bActive && PropertyModule)
+			{
+				PropertyModule->UnregisterCustomPropertyTypeLayout(Customization.Name, Customization.Identifier);
+				bNotifyPending = true;
+			}
+			return true;
+		});
+		Flush();
+	}
+
+	void UnregisterClass(FName ClassName)
+	{
+		FPropertyEditorModule* PropertyModule = FModuleManager::GetModulePtr<FPropertyEditorModule>("PropertyEditor");
+		ClassCustomizations.RemoveAll([&](const FRegisteredCustomization& Customization)
+		{
+			if (Customization.Name != ClassName)
+			{
+				return false;
+			}
+
+			if (Customization.bActive && PropertyModule)
+			{
+				PropertyModule->UnregisterCustomClassLayout(Customization.Name);
+				bNotifyPending = true;
+			}
+			return true;
+		});
+		Flush();
 	}
 
 	void UnregisterAll()
@@ -34,26 +121,105 @@ public:
 		{
 			for (const FRegisteredCustomization& Customization : PropertyCustomizations)
 			{
-				PropertyModule->UnregisterCustomPropertyTypeLayout(Customization.Name, Customization.Identifier);
+				if (Customization.bActive)
+				{
+					PropertyModule->UnregisterCustomPropertyTypeLayout(Customization.Name, Customization.Identifier);
+					bNotifyPending = true;
+				}
 			}
 
-			for (const FName& Customization : ClassCustomizations)
+			for (const FRegisteredCustomization& Customization : ClassCustomizations)
 			{
-				PropertyModule->UnregisterCustomClassLayout(Customization);
+				if (Customization.bActive)
+				{
+					PropertyModule->UnregisterCustomClassLayout(Customization.Name);
+					bNotifyPending = true;
+				}
 			}
 		}
 		PropertyCustomizations.Empty();
 		ClassCustomizations.Empty();
-	}	
+
+		if (ModulesChangedHandle.IsValid())
+		{
+			FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+			ModulesChangedHandle.Reset();
+		}
+
+		Flush();
+	}
+
+private:
+	/** Activate pending registrations and refresh details panels once */
+	void Flush()
+	{
+		FPropertyEditorModule* PropertyModule = FModuleManager::GetModulePtr<FPropertyEditorModule>("PropertyEditor");
+		if (PropertyModule == nullptr)
+		{
+			bNotifyPending = false;
+
+			const bool bHasInactive = PropertyCustomizations.Num() > 0 || ClassCustomizations.Num() > 0;
+			if (bHasInactive && !ModulesChangedHandle.IsValid())
+			{
+				ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FCustomizationBinder::OnModulesChanged);
+			}
+			return;
+		}
+
+		for (FRegisteredCustomization& Customization : PropertyCustomizations)
+		{
+			if (!Customization.bActive)
+			{
+				PropertyModule->RegisterCustomPropertyTypeLayout(Customization.Name, Customization.PropertyDelegate, Customization.Identifier);
+				Customization.bActive = true;
+				bNotifyPending = true;
+			}
+		}
+
+		for (FRegisteredCustomization& Customization : ClassCustomizations)
+		{
+			if (!Customization.bActive)
+			{
+				PropertyModule->RegisterCustomClassLayout(Customization.Name, Customization.ClassDelegate);
+				Customization.bActive = true;
+				bNotifyPending = true;
+			}
+		}
+
+		// Nothing to refresh while editor is going away
+		if (bNotifyPending && !IsEngineExitRequested())
+		{
+			PropertyModule->NotifyCustomizationModuleChanged();
+		}
+		bNotifyPending = false;
+	}
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+	{
+		if (ModuleName == TEXT("PropertyEditor") && Reason == EModuleChangeReason::ModuleLoaded)
+		{
+			FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+			ModulesChangedHandle.Reset();
+			Flush();
+		}
+	}
 
 private:
 	struct FRegisteredCustomization
 	{
 		FName Name;
 		TSharedPtr<IPropertyTypeIdentifier> Identifier;
+		FOnGetPropertyTypeCustomizationInstance PropertyDelegate;
+		FOnGetDetailCustomizationInstance ClassDelegate;
+
+		/** Registered in PropertyEditor */
+		bool bActive = false;
 	};
 
 	TArray<FRegisteredCustomization> PropertyCustomizations;
 
-	TArray<FName> ClassCustomizations;
+	TArray<FRegisteredCustomization> ClassCustomizations;
+
+	bool bNotifyPending = false;
+	FDelegateHandle ModulesChangedHandle;
 };
@@ -7,47 +7,105 @@
 #include "EditorMiscUtilitiesSettings.h"
 #include "EasyThumbnailRenderer.generated.h"
 
+class UTexture2D;
+struct FAssetData;
+
+
+/** Brush source of a class registered for EasyThumbnailRenderer */
+struct FEasyThumbnailClassInfo
+{
+	TWeakObjectPtr<UClass> TargetClass;
+
+	TWeakFieldPtr<FProperty> ThumbnailProperty;
+	TWeakObjectPtr<UFunction> ThumbnailFunction;
+
+	/** ThumbnailFunction is native and not an event, its thunk is called directly instead of going through ProcessEvent */
+	bool bNativeThumbnailFunction = false;
+
+	FAssetThumbnailSettings Settings;
+
+	bool IsValid() const
+	{
+		return TargetClass.IsValid() && (ThumbnailProperty.IsValid() || ThumbnailFunction.IsValid());
+	}
+};
 
 /**
- * 
+ * Draws FSlateBrush provided by asset property or function.
+ * Per-class data is kept in FEasyThumbnailRegistry and looked up by the drawn object class.
+ * UThumbnailManager creates a separate renderer instance for every registered class, so per-instance state is per class
  */
 UCLASS()
 class UEasyThumbnailRenderer : public UThumbnailRenderer
 {
 	GENERATED_BODY()
-private:
-	// Little kludge to send initialization data to new instance
-	struct FEasyThumbnailRendererOptions
-	{
-		bool bWaiting;
 
-		TObjectPtr<UClass> TargetClass;
+public:
+	UEasyThumbnailRenderer();
 
-		TWeakFieldPtr<FProperty> ThumbnailProperty;
-		TWeakObjectPtr<UFunction> ThumbnailFunction;
+	/** Find brush property or function on class. Fails if settings do not describe a valid brush source */
+	static bool MakeClassInfo(UClass* AssetClass, const FAssetThumbnailSettings& Settings, FEasyThumbnailClassInfo& OutInfo);
 
-		FAssetThumbnailSettings Settings;
-	};
-	static FEasyThumbnailRendererOptions InitializationData;
+	/** Registered class info for object, nullptr if object's class is not registered */
+	static const FEasyThumbnailClassInfo* GetClassInfo(const UObject* Object);
 
+	/** Get brush to draw for object. Function results are memoized until object is changed */
+	bool ResolveBrush(UObject* Object, FSlateBrush& OutBrush);
 
-public:
-	UPROPERTY()
-	TObjectPtr<UClass> TargetClass;
+	/** Hidden asset registry tags describing the brush, so it can be drawn without loading the asset */
+	static const FName BrushResourceTag;
+	static const FName BrushDrawAsTag;
+	static const FName BrushMarginTag;
+	static const FName BrushTintTag;
 
-	TWeakFieldPtr<FProperty> ThumbnailProperty;
-	TWeakObjectPtr<UFunction> ThumbnailFunction;
+	static void GetBrushTags(const FSlateBrush& Brush, TArray<UObject::FAssetRegistryTag>& OutTags);
 
-	FAssetThumbnailSettings Settings;
+	/** Rebuild brush from tags of asset. Loads only brush resource, false if asset was saved without tags */
+	static bool ResolveBrushFromTags(const FAssetData& AssetData, FSlateBrush& OutBrush);
 
-public:
-	UEasyThumbnailRenderer();
-	static bool TryRegisterForClass(class UThumbnailManager& Manager, FSoftClassPath ClassPath, const FAssetThumbnailSettings& Settings);
+	// Begin UObject Interface
+	virtual void BeginDestroy() override;
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	// End UObject Interface
 
 
 	// Begin UThumbnailRenderer Object
 	virtual EThumbnailRenderFrequency GetThumbnailRenderFrequency(UObject* Object) const override;
 	virtual bool CanVisualizeAsset(UObject* Object) override;
-	virtual void Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget*, FCanvas* Canvas, bool bAdditionalViewFamily) override;
+	virtual void Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* RenderTarget, FCanvas* Canvas, bool bAdditionalViewFamily) override;
 	// End UThumbnailRenderer Object
+
+private:
+	static void CallThumbnailFunction(UObject* Object, UFunction* Function, bool bNative, FSlateBrush& OutBrush);
+
+	/** Image is not for display but kept, e.g. saved into package or drawn by commandlet. Such draws must be complete */
+	static bool IsFinalDraw();
+
+	/** Stream in mips needed to draw RegionSize pixels of texture at thumbnail size. False while they are not resident yet, final draws wait for them */
+	bool RequestMips(UObject* Object, UTexture2D* Texture, const FVector2D& RegionSize, const FSlateBrush& Brush, uint32 Width, uint32 Height);
+
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	void OnPostGarbageCollect();
+
+	/** Brushes returned by ThumbnailFunction */
+	TMap<TWeakObjectPtr<UObject>, FSlateBrush> CachedBrushes;
+
+	/** Objects drawn before their texture was streamed in, they are rendered as realtime until it is */
+	TSet<TWeakObjectPtr<UObject>> PendingStreaming;
+
+	/** Objects whose cached image is being loaded from disk, they are rendered as realtime until it is */
+	TSet<TWeakObjectPtr<UObject>> PendingCacheLoads;
+
+	struct FRedrawState
+	{
+		/** Brush hash of the image kept in memory cache */
+		FString Key;
+		double LastDrawTime = 0.0;
+	};
+
+	/** Last image of objects with throttled redraws */
+	TMap<TWeakObjectPtr<UObject>, FRedrawState> RedrawStates;
+
+	FDelegateHandle PropertyChangedHandle;
+	FDelegateHandle PostGarbageCollectHandle;
 };
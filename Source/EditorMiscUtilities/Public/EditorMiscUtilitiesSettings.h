@@ -46,12 +46,33 @@ struct FAssetThumbnailSettings
 	UPROPERTY(EditAnywhere)
 	FLinearColor BackgroundColor;
 
+	/** Keep rendered thumbnails in Saved/EasyThumbnailCache and reuse them while brush is unchanged */
+	UPROPERTY(EditAnywhere)
+	bool bUseDiskCache;
+
+	/** Draw small brush textures (up to 128 px) from a shared atlas instead of streaming each texture in.
+	 * Atlas pages take up to 16 MB while editor runs, so enable for classes with many small icons only */
+	UPROPERTY(EditAnywhere)
+	bool bUseAtlas;
+
+	/** Realtime and OnPropertyChange only. Reuse previous image while resolved brush and its texture resource are unchanged */
+	UPROPERTY(EditAnywhere)
+	bool bSkipUnchangedRedraws;
+
+	/** Realtime and OnPropertyChange only. Minimum time between redraws of one asset, 0 for no limit */
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0, Units = "s"))
+	float MinRedrawInterval;
+
 	FAssetThumbnailSettings()
 		: PropertyOrFunction()
 		, UpdateFrequency(EAssetThumbnailUpdateFrequence::OnAssetSave)
 		, bDrawChecker(false)
 		, CheckerDensity(8)
 		, BackgroundColor(FLinearColor(0.010330f, 0.010330f, 0.010330f))
+		, bUseDiskCache(false)
+		, bUseAtlas(false)
+		, bSkipUnchangedRedraws(false)
+		, MinRedrawInterval(0.0f)
 	{
 	}
 };
@@ -104,12 +125,24 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Editor", meta = (AllowedClasses = "/Script/Engine.World"))
 	TArray<FSoftObjectPath> CommonEditorMaps;
 
+	/** List every map of the project in common maps picker, not only CommonEditorMaps */
+	UPROPERTY(config, EditAnywhere, Category = "Editor")
+	bool bListAllMapsInPicker = true;
+
+	/** Read files of hovered or previously opened common map in background, so switching to it is faster */
+	UPROPERTY(config, EditAnywhere, Category = "Editor")
+	bool bPrefetchCommonMaps = false;
+
 
 
 	/** Asset thumbnails. Restart required to apply changes */
 	UPROPERTY(config, EditAnywhere, Category = "Editor", meta = (ConfigRestartRequired = true))
 	TMap<FSoftClassPath, FAssetThumbnailSettings> AssetThumbnails;
 
+	/** Time per frame spent drawing asset thumbnails, the rest get a placeholder and are drawn in later frames. 0 disables the limit */
+	UPROPERTY(config, EditAnywhere, Category = "Editor", meta = (ClampMin = 0, Units = "ms"))
+	float ThumbnailFrameBudgetMs = 4.0f;
+
 
 
 	/** Mark these classes as hidden. Use as last resort to hide classes in pickers */
@@ -119,17 +152,60 @@ public:
 
 
 
-	/** Show tag picker menu in ActorComponent.ComponentTags property. Requires restart to enable */
-	UPROPERTY(config, EditAnywhere, Category = "Actor Component Tags", meta = (ConfigRestartRequired = true))
+	/** Show tag picker menu in ActorComponent.ComponentTags property */
+	UPROPERTY(config, EditAnywhere, Category = "Actor Component Tags")
 	bool bShowActorComponentTagPicker;
 
 	UPROPERTY(config, EditAnywhere, Category = "Actor Component Tags", meta = (AllowAbstract = true, EditCondition = "bShowActorComponentTagPicker"))
 	TMap<TSoftClassPtr<UActorComponent>, FActorComponentComponentTagOptions> ActorComponentTags;
 
+	/** Suggest this many of the most used tags across project assets. 0 disables usage indexing. Requires restart.
+	 * Usage is recorded when blueprints and levels are saved, resave assets saved before enabling this to have them counted */
+	UPROPERTY(config, EditAnywhere, Category = "Actor Component Tags", meta = (ClampMin = 0, ConfigRestartRequired = true, EditCondition = "bShowActorComponentTagPicker"))
+	int32 NumFrequentlyUsedTags = 10;
+
 public:
 	FGetActorComponentTagOptions GetActorComponentTagOptionsOverride;
 
 	TArray<FActorComponentTagOptionInfo> GetCommonActorComponentTagOptions(const UClass* ActorClass, const UClass* ComponentClass) const;
 
+	/** Options sorted by category, without duplicates. Shared and built once per component class unless override is bound */
+	TSharedRef<const TArray<FActorComponentTagOptionInfo>> GetActorComponentTagOptions(const UClass* ActorClass, const UClass* ComponentClass) const;
+
+	/** Drop cached tag options, they are rebuilt on next request */
+	void InvalidateActorComponentTagOptions();
+
+	// Begin UObject Interface
+	virtual void BeginDestroy() override;
+	virtual void PostReloadConfig(FProperty* PropertyThatWasLoaded) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// End UObject Interface
+
+private:
+	struct FActorComponentTagOptionsEntry
+	{
+		/** Options from config, without frequently used tags */
+		TSharedRef<const TArray<FActorComponentTagOptionInfo>> Configured;
+
+		/** Configured options with frequently used tags in front */
+		TSharedRef<const TArray<FActorComponentTagOptionInfo>> Options;
+
+		/** Frequently used tags and their counts Options were built with */
+		TArray<TPair<FName, int32>> MostUsed;
+
+		/** Usage index version MostUsed was checked against */
+		uint32 UsageVersion = 0;
+	};
+
+	TSharedRef<const TArray<FActorComponentTagOptionInfo>> BuildActorComponentTagOptions(const UClass* ComponentClass) const;
+	void GetFrequentlyUsedTags(const UClass* ComponentClass, TArray<TPair<FName, int32>>& OutTags) const;
+	static TSharedRef<const TArray<FActorComponentTagOptionInfo>> AddFrequentlyUsedTags(const TSharedRef<const TArray<FActorComponentTagOptionInfo>>& Configured, const TArray<TPair<FName, int32>>& MostUsed);
+
+	/** Component class to its options */
+	mutable TMap<TObjectKey<UClass>, FActorComponentTagOptionsEntry> ActorComponentTagIndex;
+
+	mutable FDelegateHandle BlueprintCompiledHandle;
 
 };